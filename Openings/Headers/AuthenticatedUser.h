@@ -8,13 +8,17 @@
 #include <unordered_map>
 
 #include "Common.h"
+#include "PermissionSnapshot.h"
 
 class AuthenticatedUser;
 using AuthenticatedUserPtr = std::unique_ptr<const AuthenticatedUser>;
 
 class AuthenticatedUser
 {
+  struct PermissionHolder;
+
   UserID id;
+  std::shared_ptr<PermissionHolder> permissions; // shared by copies, so a refresh reaches all of them
 
 private:
   AuthenticatedUser() = default;
@@ -25,6 +29,12 @@ public:
 
 public:
   UserID GetUserID() const;
+
+  // Permissions loaded at login or by the last refresh.
+  std::shared_ptr<const PermissionSnapshot> Permissions() const;
+
+  // Reloads permissions after they were granted or revoked.
+  void RefreshPermissions() const;
 };
 
 #endif // AUTHENTICATEDUSER_H
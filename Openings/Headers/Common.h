@@ -1,6 +1,8 @@
 #ifndef COMMON_H
 #define COMMON_H
 
+#include <QString>
+
 #include <functional>
 
 enum class CreateCompanyRequestStatus
@@ -11,8 +13,25 @@ enum class CreateCompanyRequestStatus
   Accepted = 4,
 };
 
+// Receives the rows of a streamed list one at a time. The row is only
+// valid during the call, and the visitor must not run queries itself:
+// the connection is still busy reading the rest of the result.
+template <class Row>
+using RowVisitor = std::function<void(const Row&)>;
+
+// Outcome of a bulk action for one of the rows it was applied to.
+template <class ID>
+struct BulkActionResult {
+  ID id;
+  QString error; // empty on success
+};
+
 constexpr ssize_t USER_USERNAME_SIZE = 30;
 constexpr ssize_t USER_NAME_SIZE = 255;
+constexpr ssize_t JOB_OPENING_TITLE_SIZE = 40;
+constexpr ssize_t JOB_OPENING_DESCRIPTION_SIZE = 255;
+// Shorter text has too few trigrams to narrow a fuzzy search down.
+constexpr ssize_t TRIGRAM_SEARCH_MIN_SIZE = 3;
 
 class CompanyID final
 {
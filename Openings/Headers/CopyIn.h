@@ -0,0 +1,41 @@
+#ifndef COPYIN_H
+#define COPYIN_H
+
+#include <QByteArray>
+#include <QSqlDatabase>
+#include <QString>
+
+struct pg_conn;
+
+// Streams rows into a table with COPY ... FROM STDIN in text format,
+// bypassing QSqlQuery. Needs the QPSQL driver. The rows become visible
+// only when Finish succeeds; destroying an unfinished copy aborts it.
+class CopyIn final
+{
+  pg_conn* connection;
+  QByteArray buffer;
+  bool active = false;
+  bool rowStarted = false;
+
+  void Separate();
+  void Flush();
+  void Abort(const char* reason);
+
+public:
+  CopyIn(QSqlDatabase db, const QString& sql);
+  CopyIn(const CopyIn&) = delete;
+  CopyIn& operator=(const CopyIn&) = delete;
+  ~CopyIn();
+
+  void AddField(const QString& value);
+  void AddField(int value);
+  void AddNull();
+  // Appends text already in COPY text format, without escaping it.
+  void AddRawField(const QByteArray& text);
+  void EndRow();
+
+  // Sends the remaining rows and returns how many the server copied.
+  qint64 Finish();
+};
+
+#endif // COPYIN_H
@@ -0,0 +1,140 @@
+#ifndef DATABASEPOOL_H
+#define DATABASEPOOL_H
+
+#include <QByteArray>
+#include <QException>
+#include <QFuture>
+#include <QObject>
+#include <QPromise>
+#include <QSqlDatabase>
+#include <QString>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <exception>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace DatabasePool {
+  // Model exceptions are rethrown as Error so that they cross threads
+  // inside a QFuture.
+  class Error final
+    : public QException
+  {
+    QByteArray message;
+
+  public:
+    explicit Error(QByteArray message);
+
+    const char* what() const noexcept override;
+    void raise() const override;
+    Error* clone() const override;
+  };
+
+  void Initialize(int size);
+  // Waits for the queued tasks, then closes the connection of every
+  // worker on the worker's thread.
+  void Shutdown();
+
+  QThreadPool& Pool();
+
+  // Connection of the calling thread. Each worker thread opens its own
+  // named connection on first use; the GUI thread keeps the default one.
+  QSqlDatabase Database();
+
+  // Rolls back unless committed, so a throw between the statements of a
+  // model function leaves neither partial rows nor an open transaction
+  // on the pooled connection.
+  class Transaction final
+  {
+    QSqlDatabase db;
+    bool committed = false;
+
+  public:
+    explicit Transaction(QSqlDatabase db);
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    ~Transaction();
+
+    void Commit();
+  };
+
+  template <class Fn>
+  auto Run(Fn fn)
+  {
+    return QtConcurrent::run(&Pool(), [fn = std::move(fn)]() mutable {
+      try {
+        return fn();
+      }
+      catch (QException&) {
+        throw;
+      }
+      catch (std::exception& ex) {
+        throw Error(ex.what());
+      }
+    });
+  }
+
+  // Like Run, for tasks that report progress or check for cancellation
+  // through the promise of the returned future.
+  template <class T, class Fn>
+  QFuture<T> RunWithPromise(Fn fn)
+  {
+    return QtConcurrent::run(&Pool(), [fn = std::move(fn)] (QPromise<T>& promise) mutable {
+      try {
+        if constexpr (std::is_void_v<T>) {
+          fn(promise);
+        }
+        else {
+          promise.addResult(fn(promise));
+        }
+      }
+      catch (QException&) {
+        throw;
+      }
+      catch (std::exception& ex) {
+        throw Error(ex.what());
+      }
+    });
+  }
+
+  // QFuture results have to be copyable.
+  template <class T>
+  std::optional<T> TakeOptional(std::unique_ptr<T> ptr)
+  {
+    if (!ptr) {
+      return std::nullopt;
+    }
+    return std::move(*ptr);
+  }
+
+  // Runs onResult or onError in the thread of context once future is done.
+  // onError also gets whatever onResult throws, a model call made from it
+  // throws std::runtime_error.
+  template <class T, class OnResult, class OnError>
+  void Deliver(
+    QFuture<T> future,
+    QObject* context,
+    OnResult onResult,
+    OnError onError
+  )
+  {
+    future
+      .then(context, std::move(onResult))
+      .onFailed(context, [onError] (const QException& ex) {
+        onError(QString(ex.what()));
+      })
+      .onFailed(context, [onError] (const std::exception& ex) {
+        onError(QString(ex.what()));
+      })
+      .onFailed(context, [onError] {
+        onError(QString("Unknown error"));
+      });
+  }
+}
+
+#endif // DATABASEPOOL_H
@@ -0,0 +1,127 @@
+#ifndef ENTITYCACHE_H
+#define ENTITYCACHE_H
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+struct EntityCacheStats
+{
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t size = 0;
+  std::size_t capacity = 0;
+};
+
+// Size-bounded LRU cache for entities loaded by id. Thread-safe.
+// Entries older than ttl are treated as missing and dropped on lookup.
+template <class Key, class Value>
+class EntityCache final
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+private:
+  struct Entry {
+    Key key;
+    Value value;
+    Clock::time_point expiresAt;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  std::size_t capacity;
+  Clock::duration ttl;
+
+  EntryList entries; // most recently used first
+  std::unordered_map<Key, typename EntryList::iterator> index;
+
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+
+  mutable std::mutex mutex;
+
+public:
+  EntityCache(std::size_t capacity, Clock::duration ttl)
+    : capacity(capacity)
+    , ttl(ttl)
+  {}
+
+  std::optional<Value> Find(Key key)
+  {
+    std::lock_guard lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+      ++misses;
+      return std::nullopt;
+    }
+
+    if (it->second->expiresAt <= Clock::now()) {
+      entries.erase(it->second);
+      index.erase(it);
+      ++misses;
+      return std::nullopt;
+    }
+
+    entries.splice(entries.begin(), entries, it->second);
+    ++hits;
+    return it->second->value;
+  }
+
+  void Insert(Key key, Value value)
+  {
+    if (capacity == 0) {
+      return;
+    }
+
+    std::lock_guard lock(mutex);
+    auto expiresAt = Clock::now() + ttl;
+
+    if (auto it = index.find(key); it != index.end()) {
+      it->second->value = std::move(value);
+      it->second->expiresAt = expiresAt;
+      entries.splice(entries.begin(), entries, it->second);
+      return;
+    }
+
+    if (entries.size() >= capacity) {
+      index.erase(entries.back().key);
+      entries.pop_back();
+    }
+
+    entries.push_front(Entry{key, std::move(value), expiresAt});
+    index.emplace(key, entries.begin());
+  }
+
+  void Invalidate(Key key)
+  {
+    std::lock_guard lock(mutex);
+    if (auto it = index.find(key); it != index.end()) {
+      entries.erase(it->second);
+      index.erase(it);
+    }
+  }
+
+  void Clear()
+  {
+    std::lock_guard lock(mutex);
+    entries.clear();
+    index.clear();
+  }
+
+  EntityCacheStats GetStats() const
+  {
+    std::lock_guard lock(mutex);
+    EntityCacheStats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.size = entries.size();
+    stats.capacity = capacity;
+    return stats;
+  }
+};
+
+#endif // ENTITYCACHE_H
@@ -4,6 +4,7 @@
 #include <QDialog>
 
 #include <memory>
+#include <optional>
 #include <variant>
 
 #include "Common.h"
@@ -11,7 +12,7 @@
 
 #include "AuthenticatedUser.h"
 
-#include <QTemporaryFile>
+#include <QFuture>
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class ApplicationDialog; }
@@ -24,9 +25,10 @@ class ApplicationDialog final
 
   AuthenticatedUser user;
   std::variant<ApplicationID, JobOpeningID> applicationOrOpeningId;
+  std::optional<UserResumeID> resumeId; // set once the stored resume is known, its contents are fetched on view
+  QByteArray resumeContentHash;
   QString resumeFilename;
-  QByteArray resume;
-  QTemporaryFile file;
+  QString resumePath; // local copy of the resume, if there is one
 
 public:
   ApplicationDialog(AuthenticatedUser user, ApplicationID, QWidget *parent = nullptr); // to view application
@@ -43,6 +45,9 @@ private slots:
 private:
   void Reload();
 
+  template <class T>
+  void ShowTransferProgress(const QFuture<T>& future, const QString& label);
+
 private:
   Ui::ApplicationDialog *ui;
 };
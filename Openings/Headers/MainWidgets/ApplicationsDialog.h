@@ -3,7 +3,10 @@
 
 #include <QWidget>
 
+#include <functional>
+
 #include "ApplicationModel.h"
+#include "ApplicationTableModel.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class ApplicationsDialog; }
@@ -15,7 +18,13 @@ class ApplicationsDialog final
   Q_OBJECT
 
   AuthenticatedUser user;
-  QList<ApplicationModel::ApplicationData> applicationList;
+  ApplicationTableModel *applicationsModel;
+
+  struct ContextMenuState {
+    bool canAccept = false;
+    bool canDeny = false;
+    bool canCancel = false;
+  };
 
   enum class Mode {
     userApplications,
@@ -32,6 +41,10 @@ public:
 
 private:
   void Reload();
+  void ShowContextMenu(const QPoint &p, ApplicationID, const ContextMenuState&);
+  void ShowBulkContextMenu(const QPoint &p, const QList<int>& rows);
+  void RunApplicationAction(std::function<void()> action, QString message);
+  void RunBulkApplicationAction(ApplicationModel::ApplicationAction, const QList<int>& rows, QString message);
 
 private slots:
   void ShowTableContextMenu(const QPoint &p);
@@ -0,0 +1,43 @@
+#ifndef BULKACTIONREPORT_H
+#define BULKACTIONREPORT_H
+
+#include <QMessageBox>
+#include <QStringList>
+#include <QWidget>
+
+#include "Common.h"
+
+// Tells how many rows a bulk action changed. Rows it skipped are listed
+// in the details with their reason; labels are aligned with results.
+template <class ID>
+void ShowBulkActionReport(
+  QWidget* parent,
+  const QString& doneMessage,
+  const QList<BulkActionResult<ID>>& results,
+  const QStringList& labels
+)
+{
+  qsizetype done = 0;
+  QStringList skipped;
+  for (qsizetype i = 0; i < results.size(); ++i) {
+    if (results[i].error.isEmpty()) {
+      ++done;
+    }
+    else {
+      skipped.append(labels.value(i) + ": " + results[i].error);
+    }
+  }
+
+  auto text = QString("%1: %2 of %3").arg(doneMessage).arg(done).arg(results.size());
+  QMessageBox box(skipped.isEmpty() ? QMessageBox::Information : QMessageBox::Warning,
+                  "Info",
+                  text,
+                  QMessageBox::Ok,
+                  parent);
+  if (!skipped.isEmpty()) {
+    box.setDetailedText(skipped.join('\n'));
+  }
+  box.exec();
+}
+
+#endif // BULKACTIONREPORT_H
@@ -2,9 +2,11 @@
 #define COMPANYLISTWIDGET_H
 
 #include <QWidget>
+#include <QTimer>
 
 #include "AuthenticatedUser.h"
 #include "CompanyModel.h"
+#include "CompanyTableModel.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class CompanyListWidget; }
@@ -16,7 +18,8 @@ class CompanyListWidget final
   Q_OBJECT
 
   AuthenticatedUser user;
-  QList<CompanyModel::CompanyData> companyList;
+  CompanyTableModel *companiesModel;
+  QTimer searchTimer; // waits for typing to pause before searching
 
 public:
   CompanyListWidget(AuthenticatedUser, QWidget *parent = nullptr);
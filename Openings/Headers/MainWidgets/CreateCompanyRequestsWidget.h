@@ -6,6 +6,7 @@
 #include "AuthenticatedUser.h"
 
 #include "CompanyModel.h"
+#include "CreateCompanyRequestTableModel.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class CreateCompanyRequestsWidget; }
@@ -17,7 +18,7 @@ class CreateCompanyRequestsWidget final
   Q_OBJECT
 
   AuthenticatedUser user;
-  QList<CompanyModel::CreateCompanyRequestData> requestList;
+  CreateCompanyRequestTableModel *requestsModel;
 
 public:
   CreateCompanyRequestsWidget(AuthenticatedUser, QWidget *parent = nullptr);
@@ -2,11 +2,15 @@
 #define JOBOPENINGDIALOG_H
 
 #include <QDialog>
+#include <QFuture>
 
 #include <memory>
+#include <optional>
 
 #include "Common.h"
 #include "UserModel.h"
+#include "CompanyModel.h"
+#include "JobOpeningModel.h"
 
 #include "AuthenticatedUser.h"
 
@@ -23,6 +27,11 @@ class JobOpeningDialog final
   std::optional<JobOpeningID> id;
   std::optional<CompanyID> companyId;
 
+  QFuture<std::optional<JobOpeningModel::JobOpeningData>> openingFuture;
+  QFuture<std::optional<CompanyModel::CompanyData>> companyFuture;
+  QFuture<std::optional<UserModel::UserData>> creatorFuture;
+  QFuture<std::optional<UserModel::UserData>> statusChangerFuture;
+
   enum Mode {
     create,
     edit,
@@ -44,6 +53,11 @@ private slots:
 
 private:
   void Reload();
+  void CancelLoads();
+  void Show(const JobOpeningModel::JobOpeningData&,
+            const CompanyModel::CompanyData&,
+            const UserModel::UserData& creator,
+            const UserModel::UserData& statusChanger);
 
 private:
   Ui::JobOpeningDialog *ui;
@@ -7,6 +7,7 @@
 #include "AuthenticatedUser.h"
 
 #include "CompanyModel.h"
+#include "CreateCompanyRequestTableModel.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MyCreateCompanyRequestsWidget; }
@@ -18,7 +19,7 @@ class MyCreateCompanyRequestsWidget final
   Q_OBJECT
 
   AuthenticatedUser user;
-  QList<CompanyModel::CreateCompanyRequestData> requestList;
+  CreateCompanyRequestTableModel *requestsModel;
 
 public:
   MyCreateCompanyRequestsWidget(AuthenticatedUser, QWidget *parent = nullptr);
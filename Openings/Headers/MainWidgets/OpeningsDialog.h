@@ -2,10 +2,12 @@
 #define OPENINGSDIALOG_H
 
 #include <QDialog>
+#include <QTimer>
 
 #include "Common.h"
 #include "AuthenticatedUser.h"
 #include "JobOpeningModel.h"
+#include "JobOpeningTableModel.h"
 
 #include <optional>
 
@@ -21,7 +23,8 @@ class OpeningsDialog final
   AuthenticatedUser user;
   std::optional<CompanyID> companyId;
 
-  QList<JobOpeningModel::JobOpeningData> jobOpeningList;
+  JobOpeningTableModel *openingsModel;
+  QTimer searchTimer; // waits for typing to pause before searching
 
   enum class Mode {
     userOpenings,
@@ -40,6 +43,9 @@ public:
 
 private:
   void Reload();
+  void ShowContextMenu(const QPoint &p, const JobOpeningModel::JobOpeningListData&, bool canWorkWithOpenings);
+  void ShowBulkContextMenu(const QPoint &p, const QList<int>& rows);
+  void CloseOpenings(const QList<int>& rows);
 
 private slots:
   void ShowTableContextMenu(const QPoint &p);
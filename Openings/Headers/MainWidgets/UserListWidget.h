@@ -2,8 +2,12 @@
 #define USERLISTWIDGET_H
 
 #include <QWidget>
+#include <QTimer>
+
+#include <functional>
 
 #include "UserModel.h"
+#include "UserTableModel.h"
 #include "AuthenticatedUser.h"
 
 QT_BEGIN_NAMESPACE
@@ -16,9 +20,25 @@ class UserListWidget final
   Q_OBJECT
 
   AuthenticatedUser user;
-  QList<UserModel::UserData> userDataList;
+  UserTableModel *usersModel;
+  QTimer searchTimer; // waits for typing to pause before searching
+
+  struct CompanyMenuState {
+    CompanyID id;
+    QString companyName;
+    bool hasWorkWithOpenings = false;
+  };
+
+  struct ContextMenuState {
+    UserID selectedUserId;
+    bool canChangeAcceptCompanyRequest = false;
+    bool hasAcceptCompanyRequest = false;
+    QList<CompanyMenuState> companies;
+  };
 
   void Reload();
+  void ShowContextMenu(const QPoint &p, const ContextMenuState&);
+  void RunPermissionChange(std::function<void()> change, bool set);
 
 public:
   UserListWidget(AuthenticatedUser, QWidget *parent = nullptr);
@@ -44,6 +44,7 @@ private slots:
   void on_userListButton_released();
   void on_exitButton_released();
   void on_createOpening_released();
+  void on_importOpenings_released();
 
 private:
   enum class Mode {
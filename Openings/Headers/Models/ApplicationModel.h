@@ -5,6 +5,8 @@
 #include "AuthenticatedUser.h"
 
 #include <QDateTime>
+#include <QFlags>
+#include <QFuture>
 #include <QList>
 
 #include <optional>
@@ -18,6 +20,13 @@ namespace ApplicationModel {
     Denied = 4,
   };
 
+  enum class ApplicationAction {
+    Cancel = 0x1,
+    Accept = 0x2,
+    Deny = 0x4,
+  };
+  Q_DECLARE_FLAGS(ApplicationActions, ApplicationAction)
+
   struct ApplicationData {
     ApplicationID id;
     JobOpeningID openingId;
@@ -28,6 +37,15 @@ namespace ApplicationModel {
     UserID statusChangerID;
   };
 
+  struct ApplicationListData : ApplicationData {
+    QString jobTitle;
+    CompanyID companyId;
+    QString companyName;
+    UserID applicantId;
+    QString applicantUsername;
+    QString statusChangerUsername;
+  };
+
   struct PostApplicationData {
     JobOpeningID openingId;
     UserResumeID resumeId;
@@ -39,14 +57,47 @@ namespace ApplicationModel {
   bool CanAccept(const ApplicationData&, AuthenticatedUser);
   bool CanDeny(const ApplicationData&, AuthenticatedUser);
 
+  // Transitions the user may apply to an application in the given status.
+  ApplicationActions AllowedActions(ApplicationStatusID, bool isApplicant, bool canManageOpening);
+  // List rows carry the applicant and the company, so no query is needed.
+  ApplicationActions AllowedActions(const ApplicationListData&, const AuthenticatedUser&);
+  // One query for the whole list; the result is aligned with ids and
+  // holds no actions for applications that do not exist.
+  QList<ApplicationActions> LoadAllowedActions(const QList<ApplicationID>& ids, AuthenticatedUser);
+
   void CancelApplication(ApplicationID, AuthenticatedUser);
   void AcceptApplication(ApplicationID, AuthenticatedUser);
   void DenyApplication(ApplicationID, AuthenticatedUser);
 
+  // Applies one action to many applications with a single statement.
+  // Eligible applications are changed, the others keep their status; the
+  // results are aligned with ids and hold the reason for each skipped one.
+  QList<BulkActionResult<ApplicationID>> ApplyTransition(ApplicationAction, const QList<ApplicationID>& ids, AuthenticatedUser);
+
   std::unique_ptr<ApplicationData> LoadApplicationByid(ApplicationID, AuthenticatedUser);
 
   QList<ApplicationData> LoadApplicationsCreatedBy(AuthenticatedUser, std::optional<ApplicationStatusID>);
   QList<ApplicationData> LoadApplicationsForOpeningsCreatedBy(AuthenticatedUser, std::optional<ApplicationStatusID>);
+
+  QList<ApplicationListData> LoadApplicationListCreatedBy(AuthenticatedUser, std::optional<ApplicationStatusID>);
+  QList<ApplicationListData> LoadApplicationListForOpeningsCreatedBy(AuthenticatedUser, std::optional<ApplicationStatusID>);
+
+  void VisitApplicationsCreatedBy(AuthenticatedUser, std::optional<ApplicationStatusID>, const RowVisitor<ApplicationData>&);
+  void VisitApplicationsForOpeningsCreatedBy(AuthenticatedUser, std::optional<ApplicationStatusID>, const RowVisitor<ApplicationData>&);
+  void VisitApplicationListCreatedBy(AuthenticatedUser, std::optional<ApplicationStatusID>, const RowVisitor<ApplicationListData>&);
+  void VisitApplicationListForOpeningsCreatedBy(AuthenticatedUser, std::optional<ApplicationStatusID>, const RowVisitor<ApplicationListData>&);
+
+  QFuture<std::optional<ApplicationData>> LoadApplicationByidAsync(ApplicationID, AuthenticatedUser);
+  QFuture<QList<ApplicationActions>> LoadAllowedActionsAsync(QList<ApplicationID> ids, AuthenticatedUser);
+  QFuture<QList<BulkActionResult<ApplicationID>>> ApplyTransitionAsync(ApplicationAction, QList<ApplicationID> ids, AuthenticatedUser);
+
+  QFuture<QList<ApplicationData>> LoadApplicationsCreatedByAsync(AuthenticatedUser, std::optional<ApplicationStatusID>);
+  QFuture<QList<ApplicationData>> LoadApplicationsForOpeningsCreatedByAsync(AuthenticatedUser, std::optional<ApplicationStatusID>);
+
+  QFuture<QList<ApplicationListData>> LoadApplicationListCreatedByAsync(AuthenticatedUser, std::optional<ApplicationStatusID>);
+  QFuture<QList<ApplicationListData>> LoadApplicationListForOpeningsCreatedByAsync(AuthenticatedUser, std::optional<ApplicationStatusID>);
 }
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(ApplicationModel::ApplicationActions)
+
 #endif // APPLICATIONMODEL_H
@@ -2,6 +2,7 @@
 #define COMPANYMODEL_H
 
 #include "Common.h"
+#include "EntityCache.h"
 
 #include <QString>
 #include <QCryptographicHash>
@@ -9,9 +10,11 @@
 
 #include "AuthenticatedUser.h"
 
+#include <QFuture>
 #include <QList>
 
 #include <memory>
+#include <optional>
 
 namespace CompanyModel {
   struct CompanyData {
@@ -20,10 +23,26 @@ namespace CompanyModel {
     UserID companyAdmin;
   };
 
+  // Position after the last row of a search page, ordered by
+  // (trigram distance, id).
+  struct CompanySearchCursor {
+    float distance;
+    CompanyID id;
+  };
+
+  struct CompanySearchPage {
+    QList<CompanyData> rows;
+    std::optional<CompanySearchCursor> next; // empty on the last page
+  };
+
   std::unique_ptr<CompanyData> LoadCompanyDataById(CompanyID);
   std::unique_ptr<CompanyData> LoadCompanyDataByName(QString);
   QList<CompanyData> LoadCompanies();
   QList<CompanyData> LoadCompaniesAdministratedBy(UserID);
+  void VisitCompanies(const RowVisitor<CompanyData>&);
+  // Companies whose name contains words resembling text, closest first.
+  // Empty for text shorter than TRIGRAM_SEARCH_MIN_SIZE.
+  CompanySearchPage SearchCompanies(QString text, std::optional<CompanySearchCursor> after, int limit);
 
   struct CreateCompanyRequestData {
     CreateCompanyRequestID id;
@@ -41,8 +60,20 @@ namespace CompanyModel {
   void DenyCreateCompanyRequest(CreateCompanyRequestID, const AuthenticatedUser& admin);
   QList<CreateCompanyRequestData> LoadCreateCompanyRequests(const AuthenticatedUser& admin);
   QList<CreateCompanyRequestData> LoadUserCreateCompanyRequests(const AuthenticatedUser& user);
+  void VisitCreateCompanyRequests(const AuthenticatedUser& admin, const RowVisitor<CreateCompanyRequestData>&);
 
   std::unique_ptr<CreateCompanyRequestData> LoadCreateCompanyRequestData(CreateCompanyRequestID);
+
+  QFuture<std::optional<CompanyData>> LoadCompanyDataByIdAsync(CompanyID);
+  QFuture<std::optional<CompanyData>> LoadCompanyDataByNameAsync(QString);
+  QFuture<QList<CompanyData>> LoadCompaniesAsync();
+  QFuture<QList<CompanyData>> LoadCompaniesAdministratedByAsync(UserID);
+  QFuture<CompanySearchPage> SearchCompaniesAsync(QString text, std::optional<CompanySearchCursor> after, int limit);
+  QFuture<QList<CreateCompanyRequestData>> LoadCreateCompanyRequestsAsync(AuthenticatedUser admin);
+  QFuture<QList<CreateCompanyRequestData>> LoadUserCreateCompanyRequestsAsync(AuthenticatedUser user);
+  QFuture<std::optional<CreateCompanyRequestData>> LoadCreateCompanyRequestDataAsync(CreateCompanyRequestID);
+
+  EntityCacheStats GetCacheStats();
 }
 
 #endif // COMPANYMODEL_H
@@ -14,6 +14,8 @@ namespace CompanyPermissionModel {
     WorkWithOpenings = 1,
   };
 
+  // Reads the session snapshot, for gating the UI. GrantPermission and
+  // RevokePermission check the database instead.
   bool CanGrantOrRevokePermission(const AuthenticatedUser& admin, CompanyID, PermissionID);
 
   std::vector<PermissionID> LoadCompanyPermissions(UserID, CompanyID);
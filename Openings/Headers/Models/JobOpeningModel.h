@@ -2,6 +2,7 @@
 #define JOBOPENINGMODEL_H
 
 #include "Common.h"
+#include "EntityCache.h"
 
 #include <QString>
 #include <QCryptographicHash>
@@ -9,9 +10,12 @@
 
 #include "AuthenticatedUser.h"
 
+#include <QFuture>
+#include <QIODevice>
 #include <QList>
 
 #include <memory>
+#include <optional>
 
 namespace JobOpeningModel {
   enum class JobOpeningStatus {
@@ -31,12 +35,52 @@ namespace JobOpeningModel {
     UserID statusChangerId;
   };
 
+  struct JobOpeningListData : JobOpeningData {
+    QString companyName;
+    QString creatorUsername;
+    QString statusChangerUsername;
+  };
+
+  // Position after the last row of a page, ordered by (create_date, id).
+  // Search pages are ordered by (rank, id) descending instead.
+  struct JobOpeningCursor {
+    qint64 createDateUsec; // microseconds since epoch, exact unlike QDateTime
+    JobOpeningID id;
+    float rank = 0; // search pages only; ts_rank is a real, so it round-trips exactly
+  };
+
+  struct JobOpeningFilters {
+    std::optional<JobOpeningStatus> status;
+    std::optional<CompanyID> company;
+    std::optional<UserID> creator;
+  };
+
+  struct JobOpeningListPage {
+    QList<JobOpeningListData> rows;
+    std::optional<JobOpeningCursor> next; // empty on the last page
+  };
+
   struct JobOpeningCreateData {
     QString title;
     QString description;
     CompanyID companyId;
   };
 
+  enum class ImportFormat {
+    Csv, // header row naming title, description and company_id
+    Json, // array of objects with title, description and companyId
+  };
+
+  struct JobOpeningImportRejection {
+    qint64 record; // 1-based, header row not counted
+    QString reason;
+  };
+
+  struct JobOpeningImportReport {
+    qint64 imported = 0;
+    QList<JobOpeningImportRejection> rejected;
+  };
+
   struct JobOpeningUpdateData {
     JobOpeningID id;
     QString title;
@@ -47,11 +91,73 @@ namespace JobOpeningModel {
                                         std::optional<CompanyID> company,
                                         std::optional<UserID> creator);
 
+  void VisitJobOpenings(std::optional<JobOpeningStatus> status,
+                        std::optional<CompanyID> company,
+                        std::optional<UserID> creator,
+                        const RowVisitor<JobOpeningData>&);
+
+  QList<JobOpeningListData> LoadJobOpeningList(std::optional<JobOpeningStatus> status,
+                                               std::optional<CompanyID> company,
+                                               std::optional<UserID> creator);
+
+  JobOpeningListPage LoadJobOpeningListPage(std::optional<JobOpeningStatus> status,
+                                            std::optional<CompanyID> company,
+                                            std::optional<UserID> creator,
+                                            std::optional<JobOpeningCursor> after,
+                                            int limit);
+
+  // Matches ranked by SearchJobOpenings: the newest ones, so that a
+  // query matching most openings doesn't rank all of them.
+  constexpr int searchCandidateLimit = 1000;
+
+  // Openings matching a web search style query (words, "phrases", or,
+  // -exclusions) over title and description, best ranked first. Only the
+  // searchCandidateLimit newest matches are ranked.
+  JobOpeningListPage SearchJobOpenings(QString query,
+                                       const JobOpeningFilters&,
+                                       std::optional<JobOpeningCursor> after,
+                                       int limit);
+
   std::unique_ptr<JobOpeningData> LoadJobOpeningById(JobOpeningID);
 
+  QFuture<QList<JobOpeningData>> LoadJobOpeningsAsync(std::optional<JobOpeningStatus> status,
+                                                      std::optional<CompanyID> company,
+                                                      std::optional<UserID> creator);
+
+  QFuture<QList<JobOpeningListData>> LoadJobOpeningListAsync(std::optional<JobOpeningStatus> status,
+                                                             std::optional<CompanyID> company,
+                                                             std::optional<UserID> creator);
+
+  QFuture<JobOpeningListPage> LoadJobOpeningListPageAsync(std::optional<JobOpeningStatus> status,
+                                                          std::optional<CompanyID> company,
+                                                          std::optional<UserID> creator,
+                                                          std::optional<JobOpeningCursor> after,
+                                                          int limit);
+
+  QFuture<JobOpeningListPage> SearchJobOpeningsAsync(QString query,
+                                                     JobOpeningFilters,
+                                                     std::optional<JobOpeningCursor> after,
+                                                     int limit);
+
+  QFuture<std::optional<JobOpeningData>> LoadJobOpeningByIdAsync(JobOpeningID);
+
   void CreateJobOpening(const JobOpeningCreateData&, const AuthenticatedUser& requester);
   void UpdateJobOpening(const JobOpeningUpdateData&, const AuthenticatedUser& requester);
   void CloseJobOpening(JobOpeningID, const AuthenticatedUser& requester);
+  // Results are aligned with ids; openings that cannot be closed keep
+  // their status and carry the reason.
+  QList<BulkActionResult<JobOpeningID>> CloseJobOpenings(const QList<JobOpeningID>& ids, const AuthenticatedUser& requester);
+
+  QFuture<QList<BulkActionResult<JobOpeningID>>> CloseJobOpeningsAsync(QList<JobOpeningID> ids, AuthenticatedUser requester);
+
+  // Creates openings from a CSV or JSON export with one COPY. Invalid
+  // records and records of companies the requester cannot work with are
+  // rejected, the rest are imported together.
+  JobOpeningImportReport ImportJobOpenings(QIODevice& source, ImportFormat, const AuthenticatedUser& requester);
+  // The format is taken from the file suffix.
+  QFuture<JobOpeningImportReport> ImportJobOpeningsAsync(QString path, AuthenticatedUser requester);
+
+  EntityCacheStats GetCacheStats();
 }
 
 #endif // JOBOPENINGMODEL_H
@@ -2,15 +2,24 @@
 #define USERMODEL_H
 
 #include "Common.h"
+#include "EntityCache.h"
+#include "PermissionSnapshot.h"
 
 #include <QString>
 #include <QCryptographicHash>
 #include <QDateTime>
 #include <QList>
+#include <QFuture>
 
 #include <memory>
+#include <optional>
 
 namespace UserModel {
+  struct LoginData {
+    UserID id;
+    PermissionSnapshot permissions;
+  };
+
   struct InsertUserData {
     QString username;
     QString name;
@@ -23,14 +32,43 @@ namespace UserModel {
     QDateTime registrationDate;
   };
 
+  // Position after the last row of a page, ordered by (registration_date, id),
+  // or by (trigram distance, id) for search pages.
+  struct UserCursor {
+    qint64 registrationDateUsec; // microseconds since epoch, exact unlike QDateTime
+    UserID id;
+    float distance = 0; // search pages only
+  };
+
+  struct UserPage {
+    QList<UserData> rows;
+    std::optional<UserCursor> next; // empty on the last page
+  };
+
   std::unique_ptr<UserData> InsertUser(const InsertUserData&, QString password);
   std::unique_ptr<UserData> LoadById(UserID);
   std::unique_ptr<UserData> LoadByUsername(QString);
   QList<UserData> LoadUsers();
+  void VisitUsers(const RowVisitor<UserData>&);
+  UserPage LoadUsersPage(std::optional<UserCursor> after, int limit);
+  // Users whose username and name contain words resembling text, closest
+  // first. Empty for text shorter than TRIGRAM_SEARCH_MIN_SIZE.
+  UserPage SearchUsers(QString text, std::optional<UserCursor> after, int limit);
   void UpdateUserData(const UserData&, QString password);
   void DeleteUser(UserID, QString password);
   bool VerifyPassword(UserID, QString password);
+  // Checks the credentials and loads the session permissions in one
+  // round trip. Throws when the user is unknown or the password is wrong.
+  LoginData Authenticate(QString username, QString password);
   void UpdatePassword(UserID, QString oldPassword, QString newPassword);
+
+  QFuture<std::optional<UserData>> LoadByIdAsync(UserID);
+  QFuture<std::optional<UserData>> LoadByUsernameAsync(QString);
+  QFuture<QList<UserData>> LoadUsersAsync();
+  QFuture<UserPage> LoadUsersPageAsync(std::optional<UserCursor> after, int limit);
+  QFuture<UserPage> SearchUsersAsync(QString text, std::optional<UserCursor> after, int limit);
+
+  EntityCacheStats GetCacheStats();
 }
 
 
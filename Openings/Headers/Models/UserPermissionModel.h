@@ -13,11 +13,22 @@ namespace UserPermissionModel {
     AcceptCompanyRequest = 1,
   };
 
-  bool CanGrantOrRevokePermission(UserID adminId, PermissionID);
+  // Reads the session snapshot, for gating the UI. GrantPermission and
+  // RevokePermission check the database instead.
+  bool CanGrantOrRevokePermission(const AuthenticatedUser& admin, PermissionID);
 
   bool HasPermission(UserID, PermissionID);
   void GrantPermission(const AuthenticatedUser& admin, UserID, PermissionID);
   void RevokePermission(const AuthenticatedUser& admin, UserID, PermissionID);
+
+  // Admin right, user permissions, company permissions and administrated
+  // companies of one user, in a single round trip.
+  PermissionSnapshot LoadPermissionSnapshot(UserID);
+
+  // UNION ALL of the (kind, permission, company) rows read by
+  // PermissionSnapshot::AddRow, for the users of a relation U with an id
+  // column, which the enclosing statement defines in a WITH clause.
+  QString PermissionRowsSql();
 }
 
 #endif // USERPERMISSIONMODEL_H
@@ -2,14 +2,24 @@
 #define USERRESUMEMODEL_H
 
 #include <QByteArray>
+#include <QFuture>
+#include <QIODevice>
 #include <QString>
 
+#include <functional>
 #include <memory>
+#include <optional>
 
 #include "Common.h"
 #include "AuthenticatedUser.h"
 
 namespace UserResumeModel {
+  // How openings_resume_content.blob is encoded.
+  enum class ResumeCodec {
+    None = 0,
+    Zlib = 1, // qCompress
+  };
+
   struct UserResumeData {
     UserResumeID id;
     UserID userId;
@@ -17,13 +27,54 @@ namespace UserResumeModel {
     QByteArray blob;
   };
 
+  // Resume without its file contents.
+  struct UserResumeInfo {
+    UserResumeID id;
+    UserID userId;
+    QString filename;
+    qint64 size;
+    QByteArray contentHash; // SHA-256 of the contents
+  };
+
   struct InsertUserResumeData {
     QString filename;
     QByteArray blob;
   };
 
+  // Contents are stored and transferred in chunks of this size.
+  constexpr qint64 resumeChunkSize = 256 * 1024;
+  // zlib level of the chunks stored with ResumeCodec::Zlib.
+  constexpr int resumeCompressionLevel = 6;
+
+  // Called before every chunk and once the transfer is done;
+  // returning false cancels the transfer.
+  using TransferProgress = std::function<bool(qint64 done, qint64 total)>;
+
+  QByteArray ContentHash(const QByteArray& blob);
+  QByteArray ContentHash(QIODevice& source); // reads source to the end
+
+  // Contents are stored once per hash. Returns the id of an existing
+  // resume when the user already uploaded the same file under that name;
+  // the contents are only sent when no one has uploaded them yet.
   UserResumeID InsertUserResume(const InsertUserResumeData&, AuthenticatedUser);
+
+  // Same as InsertUserResume, reading the contents from a seekable source
+  // one chunk at a time. A cancelled upload stores nothing.
+  UserResumeID UploadUserResume(const QString& filename, QIODevice& source, AuthenticatedUser,
+                                const TransferProgress& = {});
+  void DownloadUserResume(UserResumeID, QIODevice& target, const TransferProgress& = {});
+
   std::unique_ptr<UserResumeData> LoadUserResume(UserResumeID);
+  std::unique_ptr<UserResumeInfo> LoadUserResumeInfo(UserResumeID);
+  QByteArray LoadUserResumeBlob(UserResumeID);
+
+  QFuture<std::optional<UserResumeData>> LoadUserResumeAsync(UserResumeID);
+  QFuture<std::optional<UserResumeInfo>> LoadUserResumeInfoAsync(UserResumeID);
+  QFuture<QByteArray> LoadUserResumeBlobAsync(UserResumeID);
+
+  // Transfer the file at path; report per cent progress and stop when cancelled.
+  QFuture<UserResumeID> UploadUserResumeAsync(QString filename, QString path, AuthenticatedUser);
+  QFuture<void> DownloadUserResumeAsync(UserResumeID, QString path);
 }
 
 #endif // USERRESUMEMODEL_H
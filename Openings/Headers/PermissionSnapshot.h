@@ -0,0 +1,53 @@
+#ifndef PERMISSIONSNAPSHOT_H
+#define PERMISSIONSNAPSHOT_H
+
+#include "Common.h"
+
+#include <bitset>
+#include <unordered_map>
+
+// Every permission of one user, loaded at once and queried in memory.
+// Permissions are bits indexed by their PermissionID value.
+class PermissionSnapshot final
+{
+public:
+  using Bits = std::bitset<32>;
+
+private:
+  static constexpr int companyAdminBit = 0; // company PermissionIDs start at 1
+
+  bool admin = false;
+  Bits userPermissions;
+  std::unordered_map<CompanyID, Bits> companyPermissions;
+
+  static bool Test(const Bits&, int bit);
+
+public:
+  void SetAdmin(bool);
+  void AddUserPermission(int permission);
+  void AddCompanyPermission(CompanyID, int permission);
+  void AddAdministratedCompany(CompanyID);
+
+  // Adds one row of a permission query selecting (kind, permission,
+  // company): 0 admin right, 1 user permission, 2 company permission,
+  // 3 administrated company.
+  void AddRow(int kind, int permission, CompanyID);
+
+  bool IsAdmin() const;
+  bool IsCompanyAdmin(CompanyID) const;
+
+  template <class PermissionID>
+  bool HasUserPermission(PermissionID permission) const
+  {
+    return Test(userPermissions, int(permission));
+  }
+
+  template <class PermissionID>
+  bool HasCompanyPermission(CompanyID companyId, PermissionID permission) const
+  {
+    auto it = companyPermissions.find(companyId);
+    return it != companyPermissions.end() && Test(it->second, int(permission));
+  }
+};
+
+#endif // PERMISSIONSNAPSHOT_H
@@ -0,0 +1,30 @@
+#ifndef RESUMECACHE_H
+#define RESUMECACHE_H
+
+#include <QByteArray>
+#include <QString>
+
+// Downloaded resumes kept on disk by content hash, so that a resume
+// viewed again opens without touching the database. Used from the GUI
+// thread of each instance, several instances may share the directory;
+// downloads write to PartialPath and are moved in by Insert.
+namespace ResumeCache {
+  // maxBytes caps the directory size, the least recently viewed
+  // resumes are removed above it. Partial files of downloads that
+  // stopped long ago are removed too.
+  void Initialize(qint64 maxBytes);
+
+  // Path of the cached file marked as most recently used, or an empty
+  // string when it is not cached.
+  QString Find(const QByteArray& contentHash, const QString& filename);
+
+  // Unique per call, so concurrent downloads of the same contents don't
+  // write into one file.
+  QString PartialPath(const QByteArray& contentHash);
+
+  // Moves a finished download into the cache and returns its path. The
+  // partial file is removed when the contents are cached already.
+  QString Insert(const QByteArray& contentHash, const QString& filename, const QString& partialPath);
+}
+
+#endif // RESUMECACHE_H
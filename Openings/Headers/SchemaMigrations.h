@@ -0,0 +1,35 @@
+#ifndef SCHEMAMIGRATIONS_H
+#define SCHEMAMIGRATIONS_H
+
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+// Schema changes made after Example/db_setup.txt, applied in version
+// order and recorded in openings_schema_version. Creating indexes needs
+// the table owner, so Migrate runs on a connection of that role.
+namespace SchemaMigrations {
+  struct Migration {
+    int version;
+    QString description;
+    // Run outside a transaction, for CREATE INDEX CONCURRENTLY, which
+    // doesn't block writes to the table while the index is built. Plain
+    // CREATE INDEX would lock out writers for the whole build.
+    bool concurrent;
+    QStringList statements;
+  };
+
+  const QList<Migration>& Migrations();
+  int LatestVersion();
+
+  // 0 when no migration was applied yet.
+  int CurrentVersion(QSqlDatabase db);
+
+  // Applies every pending migration, each in its own transaction unless
+  // concurrent, and returns the applied versions. Concurrent callers wait
+  // for each other, polling for the lock between their statements.
+  QList<int> Migrate(QSqlDatabase db);
+}
+
+#endif // SCHEMAMIGRATIONS_H
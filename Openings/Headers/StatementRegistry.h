@@ -0,0 +1,139 @@
+#ifndef STATEMENTREGISTRY_H
+#define STATEMENTREGISTRY_H
+
+#include "DatabasePool.h"
+
+#include <QList>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace StatementRegistry {
+  struct StatementStats {
+    QString connectionName;
+    QString sql;
+    qint64 prepareCount = 0;
+    qint64 executeCount = 0;
+    qint64 lastRowCount = 0;
+  };
+
+  struct Entry;
+
+  // Lease of a statement prepared once per connection.
+  // Mirrors the QSqlQuery calls used by the models; the statement goes back
+  // to the registry when the lease is destroyed.
+  class Statement final
+  {
+    Entry* entry;
+    std::unique_ptr<QSqlQuery> ownQuery; // used when the shared one is leased already
+    qint64 rowCount = 0;
+
+    QSqlQuery& Query() const;
+
+  public:
+    Statement(Entry*, std::unique_ptr<QSqlQuery> ownQuery);
+    Statement(Statement&&) noexcept;
+    Statement(const Statement&) = delete;
+    Statement& operator=(const Statement&) = delete;
+    Statement& operator=(Statement&&) = delete;
+    ~Statement();
+
+    // Forward-only results are streamed instead of being buffered
+    // client-side. Has to be set before exec; reset when the lease ends.
+    void setForwardOnly(bool forward);
+
+    // Number of rows the executed statement is expected to return: the
+    // result size when the driver knows it, otherwise the row count of
+    // the previous execution.
+    qint64 SizeHint() const;
+
+    void bindValue(const QString& placeholder, const QVariant& value);
+    void addBindValue(const QVariant& value);
+    bool exec();
+    bool next();
+    QVariant value(int index) const;
+    QSqlError lastError() const;
+    QVariant lastInsertId() const;
+    int numRowsAffected() const;
+  };
+
+  // Registers sql to be prepared by Warmup. Returns sql unchanged.
+  QString Declare(const QString& sql);
+  // Registers the variants of a statement with optional parts, built by
+  // build(mask) for every mask of optionalParts bits, and returns them
+  // indexed by mask. Variants are prepared on first use, not by Warmup.
+  QStringList DeclareVariants(int optionalParts, const std::function<QString(int mask)>& build);
+  // Every statement registered by Declare or DeclareVariants, in
+  // registration order.
+  QStringList Declared();
+
+  Statement Prepare(const QString& sql, QSqlDatabase db = DatabasePool::Database());
+
+  // Prepares every declared statement on db.
+  void Warmup(QSqlDatabase db = DatabasePool::Database());
+
+  // Drops prepared statements of one connection. Must be called on the
+  // connection's thread, before the connection is removed.
+  void Forget(const QString& connectionName);
+
+  QList<StatementStats> LoadStats();
+
+  // Formats ids as an integer array literal, to be bound to a
+  // CAST(:ids AS integer[]) placeholder.
+  template <class ID>
+  QString IntArray(
+    const QList<ID>& ids
+  )
+  {
+    QString array("{");
+    for (auto& id : ids) {
+      if (array.size() > 1) {
+        array += ',';
+      }
+      array += QString::number(int(id));
+    }
+    array += '}';
+    return array;
+  }
+
+  // Decodes every row of an executed statement with read(query, row) into
+  // a list reserved from the statement's size hint.
+  template <class Row, class Read>
+  QList<Row> ReadRows(
+    Statement& query,
+    Read read
+  )
+  {
+    QList<Row> rows;
+    rows.reserve(query.SizeHint());
+    while (query.next()) {
+      read(query, rows.emplace_back());
+    }
+    return rows;
+  }
+
+  // Decodes every row of an executed statement into one reused Row and
+  // passes it to visit, without building a list.
+  template <class Row, class Read, class Visit>
+  void VisitRows(
+    Statement& query,
+    Read read,
+    Visit visit
+  )
+  {
+    Row row;
+    while (query.next()) {
+      read(query, row);
+      visit(std::as_const(row));
+    }
+  }
+}
+
+#endif // STATEMENTREGISTRY_H
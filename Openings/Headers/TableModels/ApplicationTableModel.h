@@ -0,0 +1,54 @@
+#ifndef APPLICATIONTABLEMODEL_H
+#define APPLICATIONTABLEMODEL_H
+
+#include "TableModel.h"
+
+#include "ApplicationModel.h"
+
+#include <QStringList>
+
+class ApplicationTableModel final
+  : public ListTableModel<ApplicationModel::ApplicationListData>
+{
+public:
+  enum class Mode {
+    createdBy,
+    forOpeningsCreatedBy,
+  };
+
+private:
+  AuthenticatedUser user;
+  Mode mode;
+
+  QList<ApplicationID> ids;
+  QList<JobOpeningID> openingIds;
+  QList<UserResumeID> resumeIds;
+  QList<qint64> applicationDates;
+  QList<quint8> statuses;
+  QList<qint64> statusChangeDates;
+  QList<UserID> statusChangerIds;
+  QStringList jobTitles;
+  QList<CompanyID> companyIds;
+  QStringList companyNames;
+  QList<UserID> applicantIds;
+  QStringList applicantUsernames;
+  QStringList statusChangerUsernames;
+  QList<ApplicationModel::ApplicationActions> allowedActions;
+
+protected:
+  QFuture<QList<ApplicationModel::ApplicationListData>> LoadRows() const override;
+  void ClearColumns() override;
+  void AppendToColumns(const QList<ApplicationModel::ApplicationListData>& rows) override;
+
+public:
+  ApplicationTableModel(AuthenticatedUser, Mode, QObject *parent = nullptr);
+
+  ApplicationModel::ApplicationListData RowAt(int row) const override;
+  ApplicationModel::ApplicationActions ActionsAt(int row) const;
+
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+};
+
+#endif // APPLICATIONTABLEMODEL_H
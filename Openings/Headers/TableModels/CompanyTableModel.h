@@ -0,0 +1,44 @@
+#ifndef COMPANYTABLEMODEL_H
+#define COMPANYTABLEMODEL_H
+
+#include "TableModel.h"
+
+#include "CompanyModel.h"
+
+#include <QStringList>
+
+struct CompanyTableRow : CompanyModel::CompanyData {
+  QString adminUsername;
+};
+
+class CompanyTableModel final
+  : public ListTableModel<CompanyTableRow>
+{
+  QString searchText; // rows are trigram search results unless empty
+
+  QList<CompanyID> ids;
+  QStringList companyNames;
+  QList<UserID> adminIds;
+  QStringList adminUsernames;
+
+protected:
+  QFuture<QList<CompanyTableRow>> LoadRows() const override;
+  void ClearColumns() override;
+  void AppendToColumns(const QList<CompanyTableRow>& rows) override;
+
+public:
+  explicit CompanyTableModel(QObject *parent = nullptr);
+
+  // Takes effect on the next Reload. Text shorter than
+  // TRIGRAM_SEARCH_MIN_SIZE lists every row instead. Returns whether the
+  // rows to show changed.
+  bool SetSearchText(QString);
+
+  CompanyTableRow RowAt(int row) const override;
+
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+};
+
+#endif // COMPANYTABLEMODEL_H
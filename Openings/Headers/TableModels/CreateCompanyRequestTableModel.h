@@ -0,0 +1,53 @@
+#ifndef CREATECOMPANYREQUESTTABLEMODEL_H
+#define CREATECOMPANYREQUESTTABLEMODEL_H
+
+#include "TableModel.h"
+
+#include "CompanyModel.h"
+
+#include <QStringList>
+
+struct CreateCompanyRequestTableRow : CompanyModel::CreateCompanyRequestData {
+  QString requesterUsername;
+  QString statusChangerUsername;
+};
+
+class CreateCompanyRequestTableModel final
+  : public ListTableModel<CreateCompanyRequestTableRow>
+{
+public:
+  enum class Mode {
+    allRequests, // requester column is shown
+    userRequests,
+  };
+
+private:
+  AuthenticatedUser user;
+  Mode mode;
+
+  QList<CreateCompanyRequestID> ids;
+  QStringList companyNames;
+  QList<UserID> requesterIds;
+  QStringList requesterUsernames;
+  QList<qint64> requestDates;
+  QList<quint8> statuses;
+  QList<qint64> statusChangeDates;
+  QList<UserID> statusChangerIds;
+  QStringList statusChangerUsernames;
+
+protected:
+  QFuture<QList<CreateCompanyRequestTableRow>> LoadRows() const override;
+  void ClearColumns() override;
+  void AppendToColumns(const QList<CreateCompanyRequestTableRow>& rows) override;
+
+public:
+  CreateCompanyRequestTableModel(AuthenticatedUser, Mode, QObject *parent = nullptr);
+
+  CreateCompanyRequestTableRow RowAt(int row) const override;
+
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+};
+
+#endif // CREATECOMPANYREQUESTTABLEMODEL_H
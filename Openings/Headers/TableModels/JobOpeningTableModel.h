@@ -0,0 +1,53 @@
+#ifndef JOBOPENINGTABLEMODEL_H
+#define JOBOPENINGTABLEMODEL_H
+
+#include "KeysetTableModel.h"
+
+#include "JobOpeningModel.h"
+
+#include <QStringList>
+
+#include <optional>
+
+class JobOpeningTableModel final
+  : public KeysetTableModel<JobOpeningModel::JobOpeningListPage>
+{
+  std::optional<JobOpeningModel::JobOpeningStatus> status;
+  std::optional<CompanyID> companyId;
+  std::optional<UserID> creatorId;
+  QString searchText; // rows are ranked search results unless empty
+
+  // description isn't shown and isn't kept
+  QList<JobOpeningID> ids;
+  QStringList titles;
+  QList<CompanyID> companyIds;
+  QStringList companyNames;
+  QList<qint64> createDates;
+  QList<UserID> creatorIds;
+  QStringList creatorUsernames;
+  QList<quint8> statuses;
+  QList<qint64> statusChangeDates;
+  QStringList statusChangerUsernames;
+
+protected:
+  QFuture<JobOpeningModel::JobOpeningListPage> LoadPage(std::optional<JobOpeningModel::JobOpeningCursor> after, int limit) const override;
+  void ClearColumns() override;
+  void AppendToColumns(const QList<JobOpeningModel::JobOpeningListData>& rows) override;
+
+public:
+  JobOpeningTableModel(std::optional<JobOpeningModel::JobOpeningStatus> status,
+                       std::optional<CompanyID> companyId,
+                       std::optional<UserID> creatorId,
+                       QObject *parent = nullptr);
+
+  // Takes effect on the next Reload.
+  void SetSearchText(QString);
+
+  JobOpeningModel::JobOpeningListData RowAt(int row) const override;
+
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+};
+
+#endif // JOBOPENINGTABLEMODEL_H
@@ -0,0 +1,89 @@
+#ifndef KEYSETTABLEMODEL_H
+#define KEYSETTABLEMODEL_H
+
+#include "TableModel.h"
+
+#include <optional>
+
+// Columnar model that fetches rows page by page as the view scrolls.
+// Page is a model struct with `rows` and an optional `next` cursor
+// that is empty on the last page.
+template <class Page>
+class KeysetTableModel
+  : public ColumnarTableModel<typename decltype(Page::rows)::value_type>
+{
+public:
+  using Row = typename decltype(Page::rows)::value_type;
+  using Cursor = typename decltype(Page::next)::value_type;
+
+private:
+  std::optional<Cursor> next;
+  bool exhausted = false;
+  bool fetching = false;
+  int pageSize;
+  int generation = 0; // drops pages requested before the last Reload
+
+protected:
+  virtual QFuture<Page> LoadPage(std::optional<Cursor> after, int limit) const = 0;
+
+public:
+  explicit KeysetTableModel(
+    int pageSize,
+    QObject *parent = nullptr
+  )
+    : ColumnarTableModel<Row>(parent)
+    , pageSize(pageSize)
+  {}
+
+  void Reload()
+  {
+    this->ClearRows();
+    next.reset();
+    exhausted = false;
+    fetching = false;
+    ++generation;
+
+    fetchMore(QModelIndex());
+  }
+
+  bool canFetchMore(const QModelIndex &parent) const override
+  {
+    return !parent.isValid() && !exhausted && !fetching;
+  }
+
+  void fetchMore(const QModelIndex &parent) override
+  {
+    if (!canFetchMore(parent)) {
+      return;
+    }
+
+    fetching = true;
+    auto requested = generation;
+
+    DatabasePool::Deliver(
+      LoadPage(next, pageSize),
+      this,
+      [this, requested] (Page page) {
+        if (requested != generation) {
+          return;
+        }
+
+        fetching = false;
+        next = std::move(page.next);
+        exhausted = !next.has_value();
+
+        this->AppendRows(page.rows);
+      },
+      [this, requested] (QString error) {
+        if (requested != generation) {
+          return;
+        }
+
+        fetching = false;
+        exhausted = true;
+        emit this->LoadFailed(error);
+      });
+  }
+};
+
+#endif // KEYSETTABLEMODEL_H
@@ -0,0 +1,127 @@
+#ifndef TABLEMODEL_H
+#define TABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QDateTime>
+#include <QFuture>
+#include <QList>
+#include <QString>
+
+#include <limits>
+#include <utility>
+
+#include "DatabasePool.h"
+
+// Signals can't be declared in a class template.
+class TableModelBase
+  : public QAbstractTableModel
+{
+  Q_OBJECT
+
+public:
+  using QAbstractTableModel::QAbstractTableModel;
+
+signals:
+  void LoadFailed(QString error);
+};
+
+// Table model that keeps its rows in per-column arrays.
+// Derived models split loaded rows into their columns and format cells
+// in data(), so only the visible cells are ever formatted.
+template <class Row>
+class ColumnarTableModel
+  : public TableModelBase
+{
+  int size = 0;
+
+protected:
+  static constexpr qint64 noDate = std::numeric_limits<qint64>::min();
+
+  static qint64 ToColumnDate(const QDateTime& date)
+  {
+    return date.isValid() ? date.toMSecsSinceEpoch() : noDate;
+  }
+
+  static QString FormatColumnDate(qint64 msecs)
+  {
+    if (msecs == noDate) {
+      return QString();
+    }
+    return QDateTime::fromMSecsSinceEpoch(msecs).toString("yyyy-MM-dd hh:ss:mm");
+  }
+
+  virtual void ClearColumns() = 0;
+  virtual void AppendToColumns(const QList<Row>& rows) = 0;
+
+  void ClearRows()
+  {
+    beginResetModel();
+    ClearColumns();
+    size = 0;
+    endResetModel();
+  }
+
+  void AppendRows(const QList<Row>& rows)
+  {
+    if (rows.isEmpty()) {
+      return;
+    }
+
+    beginInsertRows(QModelIndex(), size, size + rows.size() - 1);
+    AppendToColumns(rows);
+    size += rows.size();
+    endInsertRows();
+  }
+
+public:
+  using TableModelBase::TableModelBase;
+
+  // Row rebuilt from the columns. Fields that aren't kept are left empty.
+  virtual Row RowAt(int row) const = 0;
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override
+  {
+    return parent.isValid() ? 0 : size;
+  }
+};
+
+// Columnar model that loads all of its rows at once.
+template <class Row>
+class ListTableModel
+  : public ColumnarTableModel<Row>
+{
+  int generation = 0; // drops results requested before the last Reload
+
+protected:
+  virtual QFuture<QList<Row>> LoadRows() const = 0;
+
+public:
+  using ColumnarTableModel<Row>::ColumnarTableModel;
+
+  void Reload()
+  {
+    auto requested = ++generation;
+
+    DatabasePool::Deliver(
+      LoadRows(),
+      this,
+      [this, requested] (QList<Row> rows) {
+        if (requested != generation) {
+          return;
+        }
+
+        this->ClearRows();
+        this->AppendRows(rows);
+      },
+      [this, requested] (QString error) {
+        if (requested != generation) {
+          return;
+        }
+
+        this->ClearRows();
+        emit this->LoadFailed(error);
+      });
+  }
+};
+
+#endif // TABLEMODEL_H
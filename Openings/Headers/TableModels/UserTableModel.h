@@ -0,0 +1,40 @@
+#ifndef USERTABLEMODEL_H
+#define USERTABLEMODEL_H
+
+#include "KeysetTableModel.h"
+
+#include "UserModel.h"
+
+#include <QStringList>
+
+class UserTableModel final
+  : public KeysetTableModel<UserModel::UserPage>
+{
+  QString searchText; // rows are trigram search results unless empty
+
+  QList<UserID> ids;
+  QStringList usernames;
+  QStringList names;
+  QList<qint64> registrationDates;
+
+protected:
+  QFuture<UserModel::UserPage> LoadPage(std::optional<UserModel::UserCursor> after, int limit) const override;
+  void ClearColumns() override;
+  void AppendToColumns(const QList<UserModel::UserData>& rows) override;
+
+public:
+  explicit UserTableModel(QObject *parent = nullptr);
+
+  // Takes effect on the next Reload. Text shorter than
+  // TRIGRAM_SEARCH_MIN_SIZE lists every row instead. Returns whether the
+  // rows to show changed.
+  bool SetSearchText(QString);
+
+  UserModel::UserData RowAt(int row) const override;
+
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+};
+
+#endif // USERTABLEMODEL_H
@@ -1,6 +1,8 @@
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
 CONFIG += c++20
-QT += core gui widgets quick sql
+QT += core gui widgets quick sql concurrent
+CONFIG += link_pkgconfig
+PKGCONFIG += libpq # COPY is not exposed by QtSql
 QMAKE_MACOSX_DEPLOYMENT_TARGET = 10.15 # to support filesystem path
 
 SOURCES += \
@@ -17,8 +19,14 @@ SOURCES += \
     main.cpp \
     \
     Source/Common.cpp \
+    Source/StatementRegistry.cpp \
+    Source/DatabasePool.cpp \
+    Source/ResumeCache.cpp \
+    Source/CopyIn.cpp \
+    Source/SchemaMigrations.cpp \
     Source/MainWindow.cpp \
     Source/AuthenticatedUser.cpp \
+    Source/PermissionSnapshot.cpp \
     \
     Source/MainWidgets/EditUserInfoWidget.cpp \
     Source/MainWidgets/CreateCompanyWidget.cpp \
@@ -30,14 +38,27 @@ SOURCES += \
     Source/Models/UserModel.cpp \
     Source/Models/AdminModel.cpp \
     \
+    Source/TableModels/ApplicationTableModel.cpp \
+    Source/TableModels/CompanyTableModel.cpp \
+    Source/TableModels/CreateCompanyRequestTableModel.cpp \
+    Source/TableModels/JobOpeningTableModel.cpp \
+    Source/TableModels/UserTableModel.cpp \
+    \
     Source/Authentication/LoginDialog.cpp \
     Source/Authentication/LogoutDialog.cpp \
     Source/Authentication/RegisterDialog.cpp
 
 HEADERS += \
     Headers/Common.h \
+    Headers/EntityCache.h \
+    Headers/StatementRegistry.h \
+    Headers/DatabasePool.h \
+    Headers/ResumeCache.h \
+    Headers/CopyIn.h \
+    Headers/SchemaMigrations.h \
     Headers/MainWidgets/ApplicationDialog.h \
     Headers/MainWidgets/ApplicationsDialog.h \
+    Headers/MainWidgets/BulkActionReport.h \
     Headers/MainWidgets/JobOpeningDialog.h \
     Headers/MainWidgets/OpeningsDialog.h \
     Headers/Models/ApplicationModel.h \
@@ -56,10 +77,19 @@ HEADERS += \
     \
     Headers/MainWindow.h \
     Headers/AuthenticatedUser.h \
+    Headers/PermissionSnapshot.h \
     \
     Headers/Models/UserModel.h \
     Headers/Models/AdminModel.h \
     \
+    Headers/TableModels/TableModel.h \
+    Headers/TableModels/KeysetTableModel.h \
+    Headers/TableModels/ApplicationTableModel.h \
+    Headers/TableModels/CompanyTableModel.h \
+    Headers/TableModels/CreateCompanyRequestTableModel.h \
+    Headers/TableModels/JobOpeningTableModel.h \
+    Headers/TableModels/UserTableModel.h \
+    \
     Headers/Authentication/LogoutDialog.h \
     Headers/Authentication/LoginDialog.h \
     Headers/Authentication/RegisterDialog.h
@@ -86,7 +116,8 @@ INCLUDEPATH += \
     Headers \
     Headers/Authentication \
     Headers/MainWidgets \
-    Headers/Models
+    Headers/Models \
+    Headers/TableModels
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
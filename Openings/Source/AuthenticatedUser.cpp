@@ -2,26 +2,44 @@
 
 #include "UserModel.h"
 #include "AdminModel.h"
+#include "UserPermissionModel.h"
+
+#include <mutex>
+
+struct AuthenticatedUser::PermissionHolder {
+  std::mutex mutex;
+  std::shared_ptr<const PermissionSnapshot> snapshot;
+};
 
 UserID AuthenticatedUser::GetUserID() const {
   return id;
 }
 
+std::shared_ptr<const PermissionSnapshot> AuthenticatedUser::Permissions() const
+{
+  std::lock_guard lock(permissions->mutex);
+  return permissions->snapshot;
+}
+
+void AuthenticatedUser::RefreshPermissions() const
+{
+  auto snapshot = std::make_shared<const PermissionSnapshot>(UserPermissionModel::LoadPermissionSnapshot(id));
+
+  std::lock_guard lock(permissions->mutex);
+  permissions->snapshot = std::move(snapshot);
+}
+
 AuthenticatedUserPtr AuthenticatedUser::Login(
   QString username,
   QString password
 )
 {
-  auto user = UserModel::LoadByUsername(username);
-  if (!user) {
-    throw std::runtime_error( "No user with username '" +
-                              username.toStdString() + "'" );
-  }
-  if (!UserModel::VerifyPassword(user->id, password)) {
-    throw std::runtime_error( "Incorrect password" );
-  }
+  auto login = UserModel::Authenticate(username, password);
+
   auto ptr = std::unique_ptr<AuthenticatedUser>(new AuthenticatedUser);
-  ptr->id = user->id;
+  ptr->id = login.id;
+  ptr->permissions = std::make_shared<PermissionHolder>();
+  ptr->permissions->snapshot = std::make_shared<const PermissionSnapshot>(std::move(login.permissions));
   return AuthenticatedUserPtr(ptr.release());
 }
 
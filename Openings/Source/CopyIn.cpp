@@ -0,0 +1,164 @@
+#include "CopyIn.h"
+
+#include <QSqlDriver>
+#include <QVariant>
+
+#include <libpq-fe.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace  {
+  constexpr qsizetype flushSize = 1024 * 1024;
+
+  PGconn* NativeConnection(
+    QSqlDatabase db
+  )
+  {
+    auto handle = db.driver()->handle();
+    if (!handle.isValid() || std::strcmp(handle.typeName(), "PGconn*") != 0) {
+      throw std::runtime_error("COPY needs a PostgreSQL connection");
+    }
+    return *static_cast<PGconn* const*>(handle.constData());
+  }
+
+  std::string ConnectionError(
+    PGconn* connection
+  )
+  {
+    return PQerrorMessage(connection);
+  }
+}
+
+CopyIn::CopyIn(
+  QSqlDatabase db,
+  const QString& sql
+)
+  : connection(NativeConnection(db))
+{
+  auto result = PQexec(connection, sql.toUtf8().constData());
+  auto status = PQresultStatus(result);
+  PQclear(result);
+  if (status != PGRES_COPY_IN) {
+    throw std::runtime_error("Error while starting a copy.\n" + ConnectionError(connection));
+  }
+
+  active = true;
+  buffer.reserve(flushSize + flushSize / 8);
+}
+
+CopyIn::~CopyIn()
+{
+  if (active) {
+    Abort("copy was not finished");
+  }
+}
+
+void CopyIn::Separate()
+{
+  if (rowStarted) {
+    buffer += '\t';
+  }
+  rowStarted = true;
+}
+
+void CopyIn::AddField(
+  const QString& value
+)
+{
+  Separate();
+  for (auto ch : value.toUtf8()) {
+    switch (ch) {
+      case '\\': buffer += "\\\\"; break;
+      case '\t': buffer += "\\t"; break;
+      case '\n': buffer += "\\n"; break;
+      case '\r': buffer += "\\r"; break;
+      default: buffer += ch; break;
+    }
+  }
+}
+
+void CopyIn::AddField(
+  int value
+)
+{
+  Separate();
+  buffer += QByteArray::number(value);
+}
+
+void CopyIn::AddNull()
+{
+  Separate();
+  buffer += "\\N";
+}
+
+void CopyIn::AddRawField(
+  const QByteArray& text
+)
+{
+  Separate();
+  buffer += text;
+}
+
+void CopyIn::EndRow()
+{
+  buffer += '\n';
+  rowStarted = false;
+  if (buffer.size() >= flushSize) {
+    Flush();
+  }
+}
+
+void CopyIn::Flush()
+{
+  if (buffer.isEmpty()) {
+    return;
+  }
+
+  if (PQputCopyData(connection, buffer.constData(), int(buffer.size())) != 1) {
+    auto error = ConnectionError(connection);
+    Abort("sending rows failed");
+    throw std::runtime_error("Error while sending copy rows.\n" + error);
+  }
+  buffer.clear();
+}
+
+void CopyIn::Abort(
+  const char* reason
+)
+{
+  active = false;
+  PQputCopyEnd(connection, reason);
+  while (auto result = PQgetResult(connection)) {
+    PQclear(result);
+  }
+}
+
+qint64 CopyIn::Finish()
+{
+  Flush();
+
+  active = false;
+  if (PQputCopyEnd(connection, nullptr) != 1) {
+    throw std::runtime_error("Error while finishing a copy.\n" + ConnectionError(connection));
+  }
+
+  qint64 rows = 0;
+  std::string error;
+  while (auto result = PQgetResult(connection)) {
+    if (PQresultStatus(result) == PGRES_COMMAND_OK) {
+      rows = std::atoll(PQcmdTuples(result));
+    }
+    else {
+      error = PQresultErrorMessage(result);
+    }
+    PQclear(result);
+  }
+
+  if (!error.empty()) {
+    throw std::runtime_error("Error while copying rows.\n" + error);
+  }
+  return rows;
+}
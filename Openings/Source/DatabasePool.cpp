@@ -0,0 +1,149 @@
+#include "DatabasePool.h"
+
+#include "StatementRegistry.h"
+
+#include <QCoreApplication>
+#include <QSqlError>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <latch>
+#include <optional>
+#include <stdexcept>
+
+namespace  {
+  std::atomic<int> nextConnectionId = 0;
+
+  class WorkerConnection final
+  {
+    QString name;
+
+  public:
+    WorkerConnection()
+      : name("openings_worker_" + QString::number(nextConnectionId++))
+    {
+      auto db = QSqlDatabase::cloneDatabase(QSqlDatabase::defaultConnection, name);
+      if (!db.open()) {
+        auto error = db.lastError().text().toStdString();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+        throw std::runtime_error("Error while connecting worker to the database.\n" + error);
+      }
+      StatementRegistry::Warmup(db);
+    }
+
+    ~WorkerConnection()
+    {
+      StatementRegistry::Forget(name);
+      QSqlDatabase::database(name, false).close();
+      QSqlDatabase::removeDatabase(name);
+    }
+
+    QSqlDatabase Database() const
+    {
+      return QSqlDatabase::database(name, false);
+    }
+  };
+
+  // Reset by Shutdown, so the statements are forgotten and the connection
+  // removed on the worker's own thread rather than at thread exit.
+  std::optional<WorkerConnection>& ThreadConnection()
+  {
+    thread_local std::optional<WorkerConnection> connection;
+    return connection;
+  }
+}
+
+namespace DatabasePool {
+  Error::Error(
+    QByteArray message
+  )
+    : message(std::move(message))
+  {}
+
+  const char* Error::what() const noexcept
+  {
+    return message.constData();
+  }
+
+  void Error::raise() const
+  {
+    throw *this;
+  }
+
+  Error* Error::clone() const
+  {
+    return new Error(*this);
+  }
+
+  QThreadPool& Pool()
+  {
+    static QThreadPool pool;
+    return pool;
+  }
+
+  void Initialize(
+    int size
+  )
+  {
+    Pool().setMaxThreadCount(std::max(size, 1));
+    Pool().setExpiryTimeout(-1); // keep workers and their connections alive
+  }
+
+  void Shutdown()
+  {
+    Pool().clear();
+
+    // One release task per possible worker. Each one blocks until all of
+    // them have started, so no thread runs two of them and every worker
+    // releases its own connection.
+    auto workers = Pool().maxThreadCount();
+    std::latch started(workers);
+    for (int i = 0; i < workers; ++i) {
+      Pool().start([&started] {
+        ThreadConnection().reset();
+        started.arrive_and_wait();
+      });
+    }
+    Pool().waitForDone();
+  }
+
+  QSqlDatabase Database()
+  {
+    if (QThread::currentThread() == QCoreApplication::instance()->thread()) {
+      return QSqlDatabase::database();
+    }
+
+    auto& connection = ThreadConnection();
+    if (!connection) {
+      connection.emplace();
+    }
+    return connection->Database();
+  }
+
+  Transaction::Transaction(
+    QSqlDatabase db
+  )
+    : db(db)
+  {
+    if (!this->db.transaction()) {
+      throw std::runtime_error("Error while starting a transaction");
+    }
+  }
+
+  Transaction::~Transaction()
+  {
+    if (!committed) {
+      db.rollback();
+    }
+  }
+
+  void Transaction::Commit()
+  {
+    if (!db.commit()) {
+      throw std::runtime_error("Error while committing a transaction");
+    }
+    committed = true;
+  }
+}
@@ -7,10 +7,14 @@
 #include "CompanyModel.h"
 #include "JobOpeningModel.h"
 #include "UserResumeModel.h"
+#include "DatabasePool.h"
+#include "ResumeCache.h"
 
 #include <QMessageBox>
+#include <QFile>
 #include <QFileDialog>
-#include <QTemporaryFile>
+#include <QFutureWatcher>
+#include <QProgressDialog>
 #include <QDesktopServices>
 #include <QUrl>
 
@@ -68,26 +72,50 @@ ApplicationDialog::~ApplicationDialog()
   delete ui;
 }
 
+template <class T>
+void ApplicationDialog::ShowTransferProgress(
+  const QFuture<T>& future,
+  const QString& label
+)
+{
+  auto watcher = new QFutureWatcher<T>(this);
+  auto progress = new QProgressDialog(label, "Cancel", 0, 100, this);
+  progress->setWindowModality(Qt::WindowModality::WindowModal);
+
+  connect(watcher, &QFutureWatcherBase::progressValueChanged, progress, &QProgressDialog::setValue);
+  connect(progress, &QProgressDialog::canceled, watcher, &QFutureWatcherBase::cancel);
+  connect(watcher, &QFutureWatcherBase::finished, progress, &QObject::deleteLater);
+  connect(watcher, &QFutureWatcherBase::finished, watcher, &QObject::deleteLater);
+  watcher->setFuture(future);
+}
+
 void ApplicationDialog::OkReleased()
 {
   if (std::holds_alternative<JobOpeningID>(applicationOrOpeningId)) {
-    try {
-      UserResumeModel::InsertUserResumeData rData;
-      rData.blob = resume;
-      rData.filename = resumeFilename;
-      auto resumeId = UserResumeModel::InsertUserResume(rData, user);
-
-      ApplicationModel::PostApplicationData data;
-      data.openingId = std::get<JobOpeningID>(applicationOrOpeningId);
-      data.resumeId = resumeId;
-      ApplicationModel::PostApplication(data, user);
-
-      QMessageBox::information(this, "Info", "Application posted");
-    }
-    catch (std::exception& ex) {
-      QMessageBox::critical(this, "Error", ex.what());
-      return;
-    }
+    auto upload = UserResumeModel::UploadUserResumeAsync(resumeFilename, resumePath, user);
+    ShowTransferProgress(upload, "Uploading resume...");
+    DatabasePool::Deliver(
+      upload,
+      this,
+      [this] (UserResumeID resumeId) {
+        try {
+          ApplicationModel::PostApplicationData data;
+          data.openingId = std::get<JobOpeningID>(applicationOrOpeningId);
+          data.resumeId = resumeId;
+          ApplicationModel::PostApplication(data, user);
+
+          QMessageBox::information(this, "Info", "Application posted");
+        }
+        catch (std::exception& ex) {
+          QMessageBox::critical(this, "Error", ex.what());
+          return;
+        }
+        close();
+      },
+      [this] (QString error) {
+        QMessageBox::critical(this, "Error", error);
+      });
+    return;
   }
 
   close();
@@ -120,20 +148,47 @@ void ApplicationDialog::ViewOpeningReleased()
 
 void ApplicationDialog::ViewResumeReleased()
 {
-  if (resumeFilename.isEmpty() || resume.isEmpty()) {
+  if (!resumePath.isEmpty()) {
+    QDesktopServices::openUrl(QUrl::fromLocalFile(resumePath));
     return;
   }
 
-  QTemporaryFile file("XXXXXX" + resumeFilename);
-  file.setAutoRemove(false);
-  if( file.open() ) {
-    file.resize(0);
-    file.write(resume);
-    file.close();
-    auto filename = file.fileName();
-    auto url = QUrl::fromLocalFile(filename);
-    QDesktopServices::openUrl(url);
+  if (!resumeId.has_value()) {
+    return;
   }
+
+  QString partialPath;
+  try {
+    auto cached = ResumeCache::Find(resumeContentHash, resumeFilename);
+    if (!cached.isEmpty()) {
+      QDesktopServices::openUrl(QUrl::fromLocalFile(cached));
+      return;
+    }
+    partialPath = ResumeCache::PartialPath(resumeContentHash);
+  }
+  catch (std::exception& ex) {
+    QMessageBox::critical(this, "Error", ex.what());
+    return;
+  }
+
+  auto download = UserResumeModel::DownloadUserResumeAsync(resumeId.value(), partialPath);
+  ShowTransferProgress(download, "Downloading resume...");
+  DatabasePool::Deliver(
+    download,
+    this,
+    [this, partialPath, contentHash = resumeContentHash, filename = resumeFilename] {
+      try {
+        auto path = ResumeCache::Insert(contentHash, filename, partialPath);
+        QDesktopServices::openUrl(QUrl::fromLocalFile(path));
+      }
+      catch (std::exception& ex) {
+        QMessageBox::critical(this, "Error", ex.what());
+      }
+    },
+    [this, partialPath] (QString error) {
+      QFile::remove(partialPath);
+      QMessageBox::critical(this, "Error", error);
+    });
 }
 
 void ApplicationDialog::SelectResumeReleased()
@@ -145,12 +200,7 @@ void ApplicationDialog::SelectResumeReleased()
      return;
   }
 
-  QFile settingsFile(fileName);
-  if (!settingsFile.open(QIODevice::ReadOnly)) {
-    QMessageBox::critical( nullptr, "Error", "Error while opening settings file" );
-    return;
-  }
-  resume = settingsFile.readAll();
+  resumePath = fileName;
   std::filesystem::path p(fileName.toStdString());
   resumeFilename = QString::fromStdString(p.filename().string());
   ui->resumeEdit->setText(resumeFilename);
@@ -186,12 +236,14 @@ void ApplicationDialog::Reload()
       }
       ui->statusChangerEdit->setText(statusChangerData->username);
 
-      auto resume = UserResumeModel::LoadUserResume(application->resumeId);
+      auto resume = UserResumeModel::LoadUserResumeInfo(application->resumeId);
       if (!resume) {
         throw std::runtime_error("Cannot load specified resume");
       }
 
-      this->resume = resume->blob;
+      this->resumeId = resume->id;
+      this->resumeContentHash = resume->contentHash;
+      this->resumePath.clear();
       this->resumeFilename = resume->filename;
       ui->resumeEdit->setText(this->resumeFilename);
 
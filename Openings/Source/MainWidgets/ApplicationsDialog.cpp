@@ -2,11 +2,10 @@
 #include "ui_ApplicationsDialog.h"
 
 #include "ApplicationDialog.h"
+#include "BulkActionReport.h"
+#include "DatabasePool.h"
 
-#include "JobOpeningModel.h"
-#include "UserModel.h"
-#include "CompanyModel.h"
-#include "UserResumeModel.h"
+#include "ApplicationTableModel.h"
 
 #include <QMessageBox>
 #include <QAction>
@@ -28,16 +27,15 @@ ApplicationsDialog::ApplicationsDialog(
   connect(ui->applicationTable, SIGNAL(customContextMenuRequested(const QPoint &)),
           this, SLOT(ShowTableContextMenu(const QPoint &)));
 
-  ui->applicationTable->setColumnCount(7); // without description
-  ui->applicationTable->setHorizontalHeaderLabels(
-    {"Job Title",
-     "Company",
-     "Applicant",
-     "Application date",
-     "Status",
-     "Status change date",
-     "Status changer"}
-  );
+  applicationsModel = new ApplicationTableModel(
+    user,
+    mode == Mode::userApplications ? ApplicationTableModel::Mode::createdBy
+                                   : ApplicationTableModel::Mode::forOpeningsCreatedBy,
+    this);
+  connect(applicationsModel, &TableModelBase::LoadFailed, this, [this] (QString error) {
+    QMessageBox::critical(this, "Error", error);
+  });
+  ui->applicationTable->setModel(applicationsModel);
 
   Reload();
 }
@@ -68,148 +66,76 @@ std::unique_ptr<ApplicationsDialog> ApplicationsDialog::CreateUserOpeningsApplic
 
 void ApplicationsDialog::Reload()
 {
-  struct Position {
-    QString jobTitle;
-    QString companyName;
-  };
-
-  std::unordered_map<JobOpeningID, Position> jobOpeningIdToPosition;
-  std::unordered_map<UserResumeID, UserID> resumeIdToUserId;
-  std::unordered_map<UserID, QString> userIdToUsername;
-
-  try {
-    switch (mode) {
-      case Mode::userApplications:
-        applicationList = ApplicationModel::LoadApplicationsCreatedBy(user, std::nullopt);
-        break;
-
-      case Mode::userOpeningsApplications:
-        applicationList = ApplicationModel::LoadApplicationsForOpeningsCreatedBy(user, std::nullopt);
-        break;
-    }
-
-    for (auto& application : applicationList) {
-      if (!jobOpeningIdToPosition.count(application.openingId)) {
-        if (auto opening = JobOpeningModel::LoadJobOpeningById(application.openingId)) {
-          auto& position = jobOpeningIdToPosition[opening->id];
-
-          if (!userIdToUsername.count(opening->creatorId)) {
-            if (auto user = UserModel::LoadById(opening->creatorId)) {
-              userIdToUsername.emplace(user->id, user->username);
-            } else userIdToUsername.emplace(opening->creatorId, "ERROR USER");
-          }
-
-          if (auto company = CompanyModel::LoadCompanyDataById(opening->companyId)) {
-            position.companyName = company->companyName;
-          } else position.companyName = "ERROR COMPANY";
-          position.jobTitle = opening->title;
-        }
-      }
-
-      if (!resumeIdToUserId.count(application.resumeId)) {
-        if (auto resume = UserResumeModel::LoadUserResume(application.resumeId)) {
-          resumeIdToUserId.emplace(resume->id, resume->userId);
-
-          if (!userIdToUsername.count(resume->userId)) {
-            if (auto user = UserModel::LoadById(resume->userId)) {
-              userIdToUsername.emplace(user->id, user->username);
-            } else userIdToUsername.emplace(resume->userId, "ERROR USER");
-          }
-        }
-      }
-    }
-  } catch (std::exception& ex) {
-    QMessageBox::critical(this, "Error", ex.what());
-    applicationList.clear();
-    ui->applicationTable->setRowCount(0);
-    return;
-  }
-
-  std::unordered_map<ApplicationModel::ApplicationStatusID, QString> statusIdToString{
-    {ApplicationModel::ApplicationStatusID::Accepted, "Accepted"},
-    {ApplicationModel::ApplicationStatusID::Cancelled, "Cancelled"},
-    {ApplicationModel::ApplicationStatusID::Denied, "Denied"},
-    {ApplicationModel::ApplicationStatusID::Posted, "Posted"},
-  };
-
-  ui->applicationTable->setRowCount(applicationList.size());
-
-  for (int row = 0; row < ui->applicationTable->rowCount(); ++row) {
-    auto& elem = applicationList[row];
-
-    ui->applicationTable->setItem(row, 0, new QTableWidgetItem(jobOpeningIdToPosition[elem.openingId].jobTitle));
-    ui->applicationTable->setItem(row, 1, new QTableWidgetItem(jobOpeningIdToPosition[elem.openingId].companyName));
-    ui->applicationTable->setItem(row, 2, new QTableWidgetItem(userIdToUsername[resumeIdToUserId[elem.resumeId]]));
-    ui->applicationTable->setItem(row, 3, new QTableWidgetItem(elem.applicationDate.toString("yyyy-MM-dd hh:ss:mm")));
-    ui->applicationTable->setItem(row, 4, new QTableWidgetItem(statusIdToString[elem.status]));
-    ui->applicationTable->setItem(row, 5, new QTableWidgetItem(elem.statusChangeDate.toString("yyyy-MM-dd hh:ss:mm")));
-    ui->applicationTable->setItem(row, 6, new QTableWidgetItem(userIdToUsername[elem.statusChangerID]));
-  }
+  applicationsModel->Reload();
 }
 
 void ApplicationsDialog::ShowTableContextMenu(const QPoint &p)
 {
-  auto item = ui->applicationTable->itemAt(p);
-  if (!item) {
+  auto index = ui->applicationTable->indexAt(p);
+  if (!index.isValid() || index.row() >= applicationsModel->rowCount()) {
     return;
   }
 
-  auto index = ui->applicationTable->indexFromItem(item);
-  if (index.row() < 0 || index.row() >= applicationList.size()) {
+  auto selectedRows = ui->applicationTable->selectionModel()->selectedRows();
+  if (selectedRows.size() > 1 && ui->applicationTable->selectionModel()->isRowSelected(index.row())) {
+    QList<int> rows;
+    rows.reserve(selectedRows.size());
+    for (auto& selected : selectedRows) {
+      rows.append(selected.row());
+    }
+    ShowBulkContextMenu(p, rows);
     return;
   }
 
-  auto& selectedApplication = applicationList[index.row()];
+  auto actions = applicationsModel->ActionsAt(index.row());
 
+  ContextMenuState state;
+  state.canAccept = actions.testFlag(ApplicationModel::ApplicationAction::Accept);
+  state.canDeny = actions.testFlag(ApplicationModel::ApplicationAction::Deny);
+  state.canCancel = actions.testFlag(ApplicationModel::ApplicationAction::Cancel);
+  ShowContextMenu(p, applicationsModel->RowAt(index.row()).id, state);
+}
+
+void ApplicationsDialog::ShowContextMenu(
+  const QPoint &p,
+  ApplicationID applicationId,
+  const ContextMenuState& state
+)
+{
   std::vector<std::unique_ptr<QAction>> actions;
 
-  if (ApplicationModel::CanAccept(selectedApplication, user)) {
+  if (state.canAccept) {
     actions.push_back(std::make_unique<QAction>("Accept application", ui->applicationTable));
-    connect(actions.back().get(), &QAction::triggered, [this, &selectedApplication] (bool) {
-      try {
-        ApplicationModel::AcceptApplication(selectedApplication.id, user);
-        QMessageBox::information(this, "Info", "Application accepted");
-        Reload();
-      }
-      catch (std::exception& ex) {
-        QMessageBox::critical(this, "Error", ex.what());
-      }
+    connect(actions.back().get(), &QAction::triggered, [this, applicationId] (bool) {
+      RunApplicationAction([user = user, applicationId] {
+        ApplicationModel::AcceptApplication(applicationId, user);
+      }, "Application accepted");
     });
   }
 
-  if (ApplicationModel::CanDeny(selectedApplication, user)) {
+  if (state.canDeny) {
     actions.push_back(std::make_unique<QAction>("Deny application", ui->applicationTable));
-    connect(actions.back().get(), &QAction::triggered, [this, &selectedApplication] (bool) {
-      try {
-        ApplicationModel::DenyApplication(selectedApplication.id, user);
-        QMessageBox::information(this, "Info", "Application denied");
-        Reload();
-      }
-      catch (std::exception& ex) {
-        QMessageBox::critical(this, "Error", ex.what());
-      }
+    connect(actions.back().get(), &QAction::triggered, [this, applicationId] (bool) {
+      RunApplicationAction([user = user, applicationId] {
+        ApplicationModel::DenyApplication(applicationId, user);
+      }, "Application denied");
     });
   }
 
-  if (ApplicationModel::CanCancel(selectedApplication, user)) {
+  if (state.canCancel) {
     actions.push_back(std::make_unique<QAction>("Cancel application", ui->applicationTable));
-    connect(actions.back().get(), &QAction::triggered, [this, &selectedApplication] (bool) {
-      try {
-        ApplicationModel::CancelApplication(selectedApplication.id, user);
-        QMessageBox::information(this, "Info", "Application cancelled");
-        Reload();
-      }
-      catch (std::exception& ex) {
-        QMessageBox::critical(this, "Error", ex.what());
-      }
+    connect(actions.back().get(), &QAction::triggered, [this, applicationId] (bool) {
+      RunApplicationAction([user = user, applicationId] {
+        ApplicationModel::CancelApplication(applicationId, user);
+      }, "Application cancelled");
     });
   }
 
   {
     actions.push_back(std::make_unique<QAction>("View more", ui->applicationTable));
-    connect(actions.back().get(), &QAction::triggered, [this, &selectedApplication] (bool) {
+    connect(actions.back().get(), &QAction::triggered, [this, applicationId] (bool) {
       try {
-        ApplicationDialog dialog(user, selectedApplication.id, this);
+        ApplicationDialog dialog(user, applicationId, this);
         dialog.exec();
       }
       catch (std::exception& ex) {
@@ -229,3 +155,95 @@ void ApplicationsDialog::ShowTableContextMenu(const QPoint &p)
   }
   menu.exec(p);
 }
+
+void ApplicationsDialog::ShowBulkContextMenu(
+  const QPoint &p,
+  const QList<int>& rows
+)
+{
+  struct BulkAction {
+    ApplicationModel::ApplicationAction action;
+    const char* label;
+    const char* message;
+  };
+  static const BulkAction bulkActions[] {
+    {ApplicationModel::ApplicationAction::Accept, "Accept %1 applications", "Applications accepted"},
+    {ApplicationModel::ApplicationAction::Deny, "Deny %1 applications", "Applications denied"},
+    {ApplicationModel::ApplicationAction::Cancel, "Cancel %1 applications", "Applications cancelled"},
+  };
+
+  std::vector<std::unique_ptr<QAction>> actions;
+
+  for (auto& bulkAction : bulkActions) {
+    QList<int> allowedRows;
+    for (auto row : rows) {
+      if (applicationsModel->ActionsAt(row).testFlag(bulkAction.action)) {
+        allowedRows.append(row);
+      }
+    }
+    if (allowedRows.isEmpty()) {
+      continue;
+    }
+
+    actions.push_back(std::make_unique<QAction>(QString(bulkAction.label).arg(allowedRows.size()), ui->applicationTable));
+    connect(actions.back().get(), &QAction::triggered, [this, bulkAction, allowedRows] (bool) {
+      RunBulkApplicationAction(bulkAction.action, allowedRows, bulkAction.message);
+    });
+  }
+
+  if (actions.empty()) {
+    return;
+  }
+
+  QMenu menu(ui->applicationTable);
+  menu.setWindowModality(Qt::WindowModality::WindowModal);
+  for (auto& action : actions) {
+    menu.addAction( action.get() );
+  }
+  menu.exec(p);
+}
+
+void ApplicationsDialog::RunBulkApplicationAction(
+  ApplicationModel::ApplicationAction action,
+  const QList<int>& rows,
+  QString message
+)
+{
+  QList<ApplicationID> ids;
+  QStringList labels;
+  ids.reserve(rows.size());
+  labels.reserve(rows.size());
+  for (auto row : rows) {
+    auto data = applicationsModel->RowAt(row);
+    ids.append(data.id);
+    labels.append(data.jobTitle + " (" + data.applicantUsername + ")");
+  }
+
+  DatabasePool::Deliver(
+    ApplicationModel::ApplyTransitionAsync(action, ids, user),
+    this,
+    [this, message, labels] (QList<BulkActionResult<ApplicationID>> results) {
+      ShowBulkActionReport(this, message, results, labels);
+      Reload();
+    },
+    [this] (QString error) {
+      QMessageBox::critical(this, "Error", error);
+    });
+}
+
+void ApplicationsDialog::RunApplicationAction(
+  std::function<void()> action,
+  QString message
+)
+{
+  DatabasePool::Deliver(
+    DatabasePool::Run(std::move(action)),
+    this,
+    [this, message] {
+      QMessageBox::information(this, "Info", message);
+      Reload();
+    },
+    [this] (QString error) {
+      QMessageBox::critical(this, "Error", error);
+    });
+}
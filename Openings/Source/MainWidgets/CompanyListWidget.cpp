@@ -7,7 +7,7 @@
 #include <QMenu>
 #include <QAction>
 
-#include "UserModel.h"
+#include "CompanyTableModel.h"
 
 CompanyListWidget::CompanyListWidget(
   AuthenticatedUser user,
@@ -23,11 +23,20 @@ CompanyListWidget::CompanyListWidget(
   connect(ui->companyTable, SIGNAL(customContextMenuRequested(const QPoint &)),
           this, SLOT(ShowTableContextMenu(const QPoint &)));
 
-  ui->companyTable->setColumnCount(2);
-  ui->companyTable->setHorizontalHeaderLabels(
-    {"Company name",
-     "Admin"}
-  );
+  companiesModel = new CompanyTableModel(this);
+  connect(companiesModel, &TableModelBase::LoadFailed, this, [this] (QString error) {
+    QMessageBox::critical(this, "Error", error);
+  });
+  ui->companyTable->setModel(companiesModel);
+
+  searchTimer.setSingleShot(true);
+  searchTimer.setInterval(150);
+  connect(ui->searchEdit, &QLineEdit::textChanged, &searchTimer, qOverload<>(&QTimer::start));
+  connect(&searchTimer, &QTimer::timeout, this, [this] {
+    if (companiesModel->SetSearchText(ui->searchEdit->text().trimmed())) {
+      Reload();
+    }
+  });
 
   Reload();
 }
@@ -35,25 +44,20 @@ CompanyListWidget::CompanyListWidget(
 
 void CompanyListWidget::ShowTableContextMenu(const QPoint &p)
 {
-  auto item = ui->companyTable->itemAt(p);
-  if (!item) {
-    return;
-  }
-
-  auto index = ui->companyTable->indexFromItem(item);
-  if (index.row() < 0 || index.row() >= companyList.size()) {
+  auto index = ui->companyTable->indexAt(p);
+  if (!index.isValid() || index.row() >= companiesModel->rowCount()) {
     return;
   }
 
-  auto& company = companyList[index.row()];
+  auto companyId = companiesModel->RowAt(index.row()).id;
 
   std::vector<std::unique_ptr<QAction>> actions;
 
   {
     actions.push_back(std::make_unique<QAction>("View openings", ui->companyTable));
-    connect(actions.back().get(), &QAction::triggered, [this, &company] (bool) {
+    connect(actions.back().get(), &QAction::triggered, [this, companyId] (bool) {
       try {
-        auto widget = OpeningsDialog::CreateCompanyOpenOpeningsWidget(user,company.id, this);
+        auto widget = OpeningsDialog::CreateCompanyOpenOpeningsWidget(user, companyId, this);
         widget->exec();
       }
       catch (std::exception& ex) {
@@ -76,35 +80,7 @@ void CompanyListWidget::ShowTableContextMenu(const QPoint &p)
 
 void CompanyListWidget::Reload()
 {
-  std::unordered_map<int, QString> userIdToUsername;
-
-  try {
-    companyList = CompanyModel::LoadCompanies();
-
-    for (auto& company : companyList ) {
-      if (!userIdToUsername.count(company.companyAdmin)) {
-        if (auto userData = UserModel::LoadById(company.companyAdmin)) {
-          userIdToUsername.emplace(company.companyAdmin,
-                                   userData->username);
-        }
-        else userIdToUsername.emplace(company.companyAdmin, "ERROR USER");
-      }
-    }
-  } catch (std::exception& ex) {
-    QMessageBox::critical(this, "Error", ex.what());
-    companyList.clear();
-    ui->companyTable->setRowCount(0);
-    return;
-  }
-
-  ui->companyTable->setRowCount(companyList.size());
-
-  for (int row = 0; row < ui->companyTable->rowCount(); ++row) {
-    auto& elem = companyList[row];
-
-    ui->companyTable->setItem(row, 0, new QTableWidgetItem(elem.companyName));
-    ui->companyTable->setItem(row, 1, new QTableWidgetItem(userIdToUsername[elem.companyAdmin]));
-  }
+  companiesModel->Reload();
 }
 
 CompanyListWidget::~CompanyListWidget()
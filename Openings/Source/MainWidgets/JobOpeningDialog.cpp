@@ -8,6 +8,7 @@
 #include "UserModel.h"
 #include "CompanyModel.h"
 #include "CompanyPermissionModel.h"
+#include "DatabasePool.h"
 
 JobOpeningDialog::JobOpeningDialog(
   AuthenticatedUser user,
@@ -56,6 +57,7 @@ void JobOpeningDialog::CompanySelected(int index) {
 
 JobOpeningDialog::~JobOpeningDialog()
 {
+  CancelLoads();
   delete ui;
 }
 
@@ -177,37 +179,72 @@ void JobOpeningDialog::Reload()
     return;
   }
 
-  std::unique_ptr<JobOpeningModel::JobOpeningData> opening;
-  std::unique_ptr<CompanyModel::CompanyData> company;
-  std::unique_ptr<UserModel::UserData> creator;
-  std::unique_ptr<UserModel::UserData> statusChanger;
-  try {
-    opening = JobOpeningModel::LoadJobOpeningById(id.value());
-    if (!opening) {
-      ErrorReturn("No opening with such id");
-    }
+  CancelLoads();
 
-    company = CompanyModel::LoadCompanyDataById(opening->companyId);
-    if (!company) {
-      ErrorReturn("No company with such id");
-    }
+  openingFuture = JobOpeningModel::LoadJobOpeningByIdAsync(id.value());
 
-    creator = UserModel::LoadById(opening->creatorId);
-    if (!company) {
-      ErrorReturn("No creator with such id");
-    }
+  DatabasePool::Deliver(
+    openingFuture,
+    this,
+    [this] (std::optional<JobOpeningModel::JobOpeningData> opening) {
+      if (!opening) {
+        ErrorReturn("No opening with such id");
+      }
 
-    statusChanger = UserModel::LoadById(opening->statusChangerId);
-    if (!company) {
-      ErrorReturn("No statusChanger with such id");
-    }
-  }
-  catch (std::exception& ex) {
-    ErrorReturn(ex.what());
-  }
+      // the remaining lookups only depend on the opening
+      companyFuture = CompanyModel::LoadCompanyDataByIdAsync(opening->companyId);
+      creatorFuture = UserModel::LoadByIdAsync(opening->creatorId);
+      statusChangerFuture = UserModel::LoadByIdAsync(opening->statusChangerId);
+
+      QList<QFuture<void>> lookups {companyFuture, creatorFuture, statusChangerFuture};
+
+      DatabasePool::Deliver(
+        QtFuture::whenAll(lookups.begin(), lookups.end()),
+        this,
+        [this, opening = std::move(*opening)] (QList<QFuture<void>>) {
+          auto company = companyFuture.result();
+          if (!company) {
+            ErrorReturn("No company with such id");
+          }
+
+          auto creator = creatorFuture.result();
+          if (!creator) {
+            ErrorReturn("No creator with such id");
+          }
+
+          auto statusChanger = statusChangerFuture.result();
+          if (!statusChanger) {
+            ErrorReturn("No statusChanger with such id");
+          }
+
+          Show(opening, *company, *creator, *statusChanger);
+        },
+        [this] (QString error) {
+          ErrorReturn(error);
+        });
+    },
+    [this] (QString error) {
+      ErrorReturn(error);
+    });
+}
+
+void JobOpeningDialog::CancelLoads()
+{
+  openingFuture.cancel();
+  companyFuture.cancel();
+  creatorFuture.cancel();
+  statusChangerFuture.cancel();
+}
 
+void JobOpeningDialog::Show(
+  const JobOpeningModel::JobOpeningData& opening,
+  const CompanyModel::CompanyData& company,
+  const UserModel::UserData& creator,
+  const UserModel::UserData& statusChanger
+)
+{
   QString status;
-  switch (opening->status) {
+  switch (opening.status) {
     case JobOpeningModel::JobOpeningStatus::Closed:
       status = "Closed";
       break;
@@ -220,12 +257,12 @@ void JobOpeningDialog::Reload()
       status = "ERROR STATUS";
   }
 
-  ui->titleEdit->setText(opening->title);
-  ui->descriptionEdit->setPlainText(opening->description);
-  ui->selectedCompanyEdit->setText(company->companyName);
-  ui->createDateEdit->setText(opening->createDate.toString("yyyy-MM-dd hh:ss:mm"));
-  ui->creatorEdit->setText(creator->username);
+  ui->titleEdit->setText(opening.title);
+  ui->descriptionEdit->setPlainText(opening.description);
+  ui->selectedCompanyEdit->setText(company.companyName);
+  ui->createDateEdit->setText(opening.createDate.toString("yyyy-MM-dd hh:ss:mm"));
+  ui->creatorEdit->setText(creator.username);
   ui->statusEdit->setText(status);
-  ui->statusChangeDateEdit->setText(opening->createDate.toString("yyyy-MM-dd hh:ss:mm"));
-  ui->statusChangerEdit->setText(statusChanger->name);
+  ui->statusChangeDateEdit->setText(opening.createDate.toString("yyyy-MM-dd hh:ss:mm"));
+  ui->statusChangerEdit->setText(statusChanger.name);
 }
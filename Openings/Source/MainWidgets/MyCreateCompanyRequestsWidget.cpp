@@ -3,10 +3,13 @@
 
 #include "UserModel.h"
 #include "CompanyModel.h"
+#include "DatabasePool.h"
+#include "CreateCompanyRequestTableModel.h"
 
 #include <QMessageBox>
 #include <QAction>
 #include <QMenu>
+#include <unordered_map>
 #include <vector>
 
 MyCreateCompanyRequestsWidget::MyCreateCompanyRequestsWidget(
@@ -23,86 +26,47 @@ MyCreateCompanyRequestsWidget::MyCreateCompanyRequestsWidget(
   connect(ui->companyRequestsTable, SIGNAL(customContextMenuRequested(const QPoint &)),
           this, SLOT(ShowTableContextMenu(const QPoint &)));
 
-  ui->companyRequestsTable->setColumnCount(5);
-  ui->companyRequestsTable->setHorizontalHeaderLabels(
-    {"Company name",
-     "Request date",
-     "Status",
-     "Status change date",
-     "Status changer"}
-  );
+  requestsModel = new CreateCompanyRequestTableModel(user, CreateCompanyRequestTableModel::Mode::userRequests, this);
+  connect(requestsModel, &TableModelBase::LoadFailed, this, [this] (QString error) {
+    QMessageBox::critical(this, "Error", error);
+  });
+  ui->companyRequestsTable->setModel(requestsModel);
 
   Reload();
 }
 
 void MyCreateCompanyRequestsWidget::Reload()
 {
-  std::unordered_map<int, QString> userIdToUsername;
-
-  try {
-    requestList = CompanyModel::LoadUserCreateCompanyRequests(user);
-
-    for (auto& req : requestList) {
-      if (!userIdToUsername.count(req.statusChangerId)) {
-        if (auto userData = UserModel::LoadById(req.statusChangerId)) {
-          userIdToUsername.emplace(req.statusChangerId,
-                                   userData->username);
-        }
-        else userIdToUsername.emplace(req.statusChangerId, "ERROR USER");
-      }
-    }
-  } catch (std::exception& ex) {
-    QMessageBox::critical(this, "Error", ex.what());
-    requestList.clear();
-    ui->companyRequestsTable->setRowCount(0);
-    return;
-  }
-
-  ui->companyRequestsTable->setRowCount(requestList.size());
-
-  static std::unordered_map<CreateCompanyRequestStatus, QString> statusIdToStatusString {
-    {CreateCompanyRequestStatus::Accepted, "Accepted"},
-    {CreateCompanyRequestStatus::Cancelled, "Cancelled"},
-    {CreateCompanyRequestStatus::Denied, "Denied"},
-    {CreateCompanyRequestStatus::Posted, "Posted"},
-  };
-
-  for (int row = 0; row < ui->companyRequestsTable->rowCount(); ++row) {
-    auto& elem = requestList[row];
-
-    ui->companyRequestsTable->setItem(row, 0, new QTableWidgetItem(elem.companyName));
-    ui->companyRequestsTable->setItem(row, 1, new QTableWidgetItem(elem.requestDate.toString("yyyy-MM-dd hh:ss:mm")));
-    ui->companyRequestsTable->setItem(row, 2, new QTableWidgetItem(statusIdToStatusString[elem.status]));
-    ui->companyRequestsTable->setItem(row, 3, new QTableWidgetItem(elem.statusChangeDate.toString("yyyy-MM-dd hh:ss:mm")));
-    ui->companyRequestsTable->setItem(row, 4, new QTableWidgetItem(userIdToUsername[elem.statusChangerId]));
-  }
+  requestsModel->Reload();
 }
 
 void MyCreateCompanyRequestsWidget::ShowTableContextMenu(const QPoint &p)
 {
-  auto item = ui->companyRequestsTable->itemAt(p);
-  if (!item) {
+  auto index = ui->companyRequestsTable->indexAt(p);
+  if (!index.isValid() || index.row() >= requestsModel->rowCount()) {
     return;
   }
 
-  auto index = ui->companyRequestsTable->indexFromItem(item);
-  if (index.row() < 0 || index.row() >= requestList.size()) {
-    return;
-  }
+  auto selectedRequest = requestsModel->RowAt(index.row());
+  auto requestId = selectedRequest.id;
 
   std::vector<std::unique_ptr<QAction>> actions;
 
-  if (requestList[index.row()].status == CreateCompanyRequestStatus::Posted) {
+  if (selectedRequest.status == CreateCompanyRequestStatus::Posted) {
     actions.push_back(std::make_unique<QAction>("Cancel request", ui->companyRequestsTable));
-    connect(actions.back().get(), &QAction::triggered, [this, index] (bool) {
-      try{
-        CompanyModel::CancelCreateCompanyRequest(requestList[index.row()].id, user);
-        QMessageBox::information(this, "Info", "Request was cancelled");
-        Reload();
-      }
-      catch (std::exception& ex) {
-        QMessageBox::critical(this, "Error", ex.what());
-      }
+    connect(actions.back().get(), &QAction::triggered, [this, requestId] (bool) {
+      DatabasePool::Deliver(
+        DatabasePool::Run([user = user, requestId] {
+          CompanyModel::CancelCreateCompanyRequest(requestId, user);
+        }),
+        this,
+        [this] {
+          QMessageBox::information(this, "Info", "Request was cancelled");
+          Reload();
+        },
+        [this] (QString error) {
+          QMessageBox::critical(this, "Error", error);
+        });
     });
   }
 
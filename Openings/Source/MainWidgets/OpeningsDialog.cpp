@@ -2,12 +2,14 @@
 #include "ui_OpeningsDialog.h"
 
 #include "JobOpeningModel.h"
-#include "UserModel.h"
-#include "CompanyModel.h"
 #include "CompanyPermissionModel.h"
+#include "DatabasePool.h"
+
+#include "JobOpeningTableModel.h"
 
 #include "JobOpeningDialog.h"
 #include "ApplicationDialog.h"
+#include "BulkActionReport.h"
 
 #include <QMessageBox>
 #include <QAction>
@@ -36,16 +38,36 @@ OpeningsDialog::OpeningsDialog(
   connect(ui->openingsTable, SIGNAL(customContextMenuRequested(const QPoint &)),
           this, SLOT(ShowTableContextMenu(const QPoint &)));
 
-  ui->openingsTable->setColumnCount(7); // without description
-  ui->openingsTable->setHorizontalHeaderLabels(
-    {"Job Title",
-     "Company",
-     "Create date",
-     "Creator",
-     "Status",
-     "Status change date",
-     "Status changer"}
-  );
+  std::optional<JobOpeningModel::JobOpeningStatus> status;
+  std::optional<UserID> creatorId;
+
+  switch (mode) {
+    case Mode::companyOpenOpenings:
+      status = JobOpeningModel::JobOpeningStatus::Posted;
+      break;
+
+    case Mode::openOpenings:
+      status = JobOpeningModel::JobOpeningStatus::Posted;
+      break;
+
+    case Mode::userOpenings:
+      creatorId = this->user.GetUserID();
+      break;
+  }
+
+  openingsModel = new JobOpeningTableModel(status, companyId, creatorId, this);
+  connect(openingsModel, &TableModelBase::LoadFailed, this, [this] (QString error) {
+    QMessageBox::critical(this, "Error", error);
+  });
+  ui->openingsTable->setModel(openingsModel);
+
+  searchTimer.setSingleShot(true);
+  searchTimer.setInterval(300);
+  connect(ui->searchEdit, &QLineEdit::textChanged, &searchTimer, qOverload<>(&QTimer::start));
+  connect(&searchTimer, &QTimer::timeout, this, [this] {
+    openingsModel->SetSearchText(ui->searchEdit->text().trimmed());
+    Reload();
+  });
 
   Reload();
 }
@@ -86,125 +108,69 @@ std::unique_ptr<OpeningsDialog> OpeningsDialog::CreateOpenOpeningsWidget(
 
 void OpeningsDialog::Reload()
 {
-  std::optional<JobOpeningModel::JobOpeningStatus> status;
-  std::optional<CompanyID> companyId;
-  std::optional<UserID> creatorId;
-
-  switch (mode) {
-    case Mode::companyOpenOpenings:
-      companyId = this->companyId;
-      status = JobOpeningModel::JobOpeningStatus::Posted;
-      break;
-
-    case Mode::openOpenings:
-      status = JobOpeningModel::JobOpeningStatus::Posted;
-      break;
-
-    case Mode::userOpenings:
-      creatorId = this->user.GetUserID();
-      break;
-  }
-
-  try {
-  }
-  catch (std::exception& ex) {
-    ErrorReturn(ex.what());
-  }
-
-  std::unordered_map<int, QString> companyIdToName;
-  std::unordered_map<int, QString> userIdToUsername;
-  try {
-    jobOpeningList = JobOpeningModel::LoadJobOpenings(status, companyId, creatorId);
-
-    for (auto& jo : jobOpeningList) {
-      if (!userIdToUsername.count(jo.creatorId)) {
-        if (auto userData = UserModel::LoadById(jo.creatorId)) {
-          userIdToUsername.emplace(jo.creatorId, userData->username);
-        }
-        else userIdToUsername.emplace(jo.creatorId, "ERROR USER");
-      }
-
-      if (!userIdToUsername.count(jo.statusChangerId)) {
-        if (auto userData = UserModel::LoadById(jo.statusChangerId)) {
-          userIdToUsername.emplace(jo.statusChangerId, userData->username);
-        }
-        else userIdToUsername.emplace(jo.statusChangerId, "ERROR USER");
-      }
-
-      if (!companyIdToName.count(jo.companyId)) {
-        if (auto companyData = CompanyModel::LoadCompanyDataById(jo.companyId)) {
-          companyIdToName.emplace(jo.companyId, companyData->companyName);
-        }
-        else companyIdToName.emplace(jo.companyId, "ERROR COMPANY");
-      }
-    }
-  }
-  catch (std::exception& ex) {
-    QMessageBox::critical(this, "Error", ex.what());
-    jobOpeningList.clear();
-    ui->openingsTable->setRowCount(0);
-    return;
-  }
-
-  static std::unordered_map<JobOpeningModel::JobOpeningStatus, QString> statusIdToStatusString {
-    {JobOpeningModel::JobOpeningStatus::Closed, "Closed"},
-    {JobOpeningModel::JobOpeningStatus::Posted, "Open"},
-  };
-
-  ui->openingsTable->setRowCount(jobOpeningList.size());
-
-  for (int row = 0; row < ui->openingsTable->rowCount(); ++row) {
-    auto& elem = jobOpeningList[row];
-
-    ui->openingsTable->setItem(row, 0, new QTableWidgetItem(elem.title));
-    ui->openingsTable->setItem(row, 1, new QTableWidgetItem(companyIdToName[elem.companyId]));
-    ui->openingsTable->setItem(row, 2, new QTableWidgetItem(elem.createDate.toString("yyyy-MM-dd hh:ss:mm")));
-    ui->openingsTable->setItem(row, 3, new QTableWidgetItem(userIdToUsername[elem.creatorId]));
-    ui->openingsTable->setItem(row, 4, new QTableWidgetItem(statusIdToStatusString[elem.status]));
-    ui->openingsTable->setItem(row, 5, new QTableWidgetItem(elem.statusChangeDate.toString("yyyy-MM-dd hh:ss:mm")));
-    ui->openingsTable->setItem(row, 6, new QTableWidgetItem(userIdToUsername[elem.statusChangerId]));
-  }
+  openingsModel->Reload();
 }
 
 void OpeningsDialog::ShowTableContextMenu(const QPoint &p)
 {
-  auto item = ui->openingsTable->itemAt(p);
-  if (!item) {
+  auto index = ui->openingsTable->indexAt(p);
+  if (!index.isValid() || index.row() >= openingsModel->rowCount()) {
     return;
   }
 
-  auto index = ui->openingsTable->indexFromItem(item);
-  if (index.row() < 0 || index.row() >= jobOpeningList.size()) {
+  auto selectedRows = ui->openingsTable->selectionModel()->selectedRows();
+  if (selectedRows.size() > 1 && ui->openingsTable->selectionModel()->isRowSelected(index.row())) {
+    QList<int> rows;
+    rows.reserve(selectedRows.size());
+    for (auto& selected : selectedRows) {
+      rows.append(selected.row());
+    }
+    ShowBulkContextMenu(p, rows);
     return;
   }
 
-  auto& selectedOpening = jobOpeningList[index.row()];
+  auto selectedOpening = openingsModel->RowAt(index.row());
+
+  auto canWorkWithOpenings =
+    selectedOpening.status == JobOpeningModel::JobOpeningStatus::Posted &&
+    user.Permissions()->HasCompanyPermission(selectedOpening.companyId,
+                                             CompanyPermissionModel::PermissionID::WorkWithOpenings);
+  ShowContextMenu(p, selectedOpening, canWorkWithOpenings);
+}
 
+void OpeningsDialog::ShowContextMenu(
+  const QPoint &p,
+  const JobOpeningModel::JobOpeningListData& selectedOpening,
+  bool canWorkWithOpenings
+)
+{
   std::vector<std::unique_ptr<QAction>> actions;
 
   if (selectedOpening.status == JobOpeningModel::JobOpeningStatus::Posted &&
-      CompanyPermissionModel::HasPermission(user.GetUserID(),
-                                            selectedOpening.companyId,
-                                            CompanyPermissionModel::PermissionID::WorkWithOpenings)) {
+      canWorkWithOpenings) {
     actions.push_back(std::make_unique<QAction>("Close opening", ui->openingsTable));
-    connect(actions.back().get(), &QAction::triggered, [this, &selectedOpening] (bool) {
-      try {
-        JobOpeningModel::CloseJobOpening(selectedOpening.id, user);
-        QMessageBox::information(this, "Info", "Job opening closed");
-        Reload();
-      }
-      catch (std::exception& ex) {
-        QMessageBox::critical(this, "Error", ex.what());
-      }
+    connect(actions.back().get(), &QAction::triggered, [this, openingId = selectedOpening.id] (bool) {
+      DatabasePool::Deliver(
+        DatabasePool::Run([user = user, openingId] {
+          JobOpeningModel::CloseJobOpening(openingId, user);
+        }),
+        this,
+        [this] {
+          QMessageBox::information(this, "Info", "Job opening closed");
+          Reload();
+        },
+        [this] (QString error) {
+          QMessageBox::critical(this, "Error", error);
+        });
     });
   }
 
   if (selectedOpening.status == JobOpeningModel::JobOpeningStatus::Posted &&
       selectedOpening.creatorId == user.GetUserID()) {
     actions.push_back(std::make_unique<QAction>("Edit opening", ui->openingsTable));
-    connect(actions.back().get(), &QAction::triggered, [this, &selectedOpening] (bool) {
+    connect(actions.back().get(), &QAction::triggered, [this, openingId = selectedOpening.id] (bool) {
       try {
-        auto widget = JobOpeningDialog::EditJobOpeningWidget(user, selectedOpening.id, this);
+        auto widget = JobOpeningDialog::EditJobOpeningWidget(user, openingId, this);
         widget->exec();
       }
       catch (std::exception& ex) {
@@ -215,9 +181,9 @@ void OpeningsDialog::ShowTableContextMenu(const QPoint &p)
 
   {
     actions.push_back(std::make_unique<QAction>("View more", ui->openingsTable));
-    connect(actions.back().get(), &QAction::triggered, [this, &selectedOpening] (bool) {
+    connect(actions.back().get(), &QAction::triggered, [this, openingId = selectedOpening.id] (bool) {
       try {
-        auto widget = JobOpeningDialog::ViewJobOpeningWidget(user, selectedOpening.id, this);
+        auto widget = JobOpeningDialog::ViewJobOpeningWidget(user, openingId, this);
         widget->exec();
       }
       catch (std::exception& ex) {
@@ -228,9 +194,9 @@ void OpeningsDialog::ShowTableContextMenu(const QPoint &p)
 
   {
     actions.push_back(std::make_unique<QAction>("Apply", ui->openingsTable));
-    connect(actions.back().get(), &QAction::triggered, [this, &selectedOpening] (bool) {
+    connect(actions.back().get(), &QAction::triggered, [this, openingId = selectedOpening.id] (bool) {
       try {
-        auto widget = std::make_unique<ApplicationDialog>(user, selectedOpening.id, this);
+        auto widget = std::make_unique<ApplicationDialog>(user, openingId, this);
         widget->exec();
       }
       catch (std::exception& ex) {
@@ -251,3 +217,60 @@ void OpeningsDialog::ShowTableContextMenu(const QPoint &p)
   menu.exec(p);
 }
 
+void OpeningsDialog::ShowBulkContextMenu(
+  const QPoint &p,
+  const QList<int>& rows
+)
+{
+  auto permissions = user.Permissions();
+
+  QList<int> closableRows;
+  for (auto row : rows) {
+    auto opening = openingsModel->RowAt(row);
+    if (opening.status == JobOpeningModel::JobOpeningStatus::Posted &&
+        permissions->HasCompanyPermission(opening.companyId,
+                                          CompanyPermissionModel::PermissionID::WorkWithOpenings)) {
+      closableRows.append(row);
+    }
+  }
+
+  if (closableRows.isEmpty()) {
+    return;
+  }
+
+  QAction closeAction(QString("Close %1 openings").arg(closableRows.size()), ui->openingsTable);
+  connect(&closeAction, &QAction::triggered, [this, closableRows] (bool) {
+    CloseOpenings(closableRows);
+  });
+
+  QMenu menu(ui->openingsTable);
+  menu.setWindowModality(Qt::WindowModality::WindowModal);
+  menu.addAction(&closeAction);
+  menu.exec(p);
+}
+
+void OpeningsDialog::CloseOpenings(
+  const QList<int>& rows
+)
+{
+  QList<JobOpeningID> ids;
+  QStringList labels;
+  ids.reserve(rows.size());
+  labels.reserve(rows.size());
+  for (auto row : rows) {
+    auto opening = openingsModel->RowAt(row);
+    ids.append(opening.id);
+    labels.append(opening.title);
+  }
+
+  DatabasePool::Deliver(
+    JobOpeningModel::CloseJobOpeningsAsync(ids, user),
+    this,
+    [this, labels] (QList<BulkActionResult<JobOpeningID>> results) {
+      ShowBulkActionReport(this, "Job openings closed", results, labels);
+      Reload();
+    },
+    [this] (QString error) {
+      QMessageBox::critical(this, "Error", error);
+    });
+}
@@ -12,6 +12,9 @@
 #include "CompanyModel.h"
 #include "CompanyPermissionModel.h"
 #include "UserPermissionModel.h"
+#include "DatabasePool.h"
+
+#include "UserTableModel.h"
 
 UserListWidget::UserListWidget(
   AuthenticatedUser user,
@@ -27,108 +30,111 @@ UserListWidget::UserListWidget(
   connect(ui->userTable, SIGNAL(customContextMenuRequested(const QPoint &)),
           this, SLOT(ShowTableContextMenu(const QPoint &)));
 
-  ui->userTable->setColumnCount(3);
-  ui->userTable->setHorizontalHeaderLabels(
-    {"Username",
-     "Name",
-     "Registration date"}
-  );
+  usersModel = new UserTableModel(this);
+  connect(usersModel, &TableModelBase::LoadFailed, this, [this] (QString error) {
+    QMessageBox::critical(this, "Error", error);
+  });
+  ui->userTable->setModel(usersModel);
+
+  searchTimer.setSingleShot(true);
+  searchTimer.setInterval(150);
+  connect(ui->searchEdit, &QLineEdit::textChanged, &searchTimer, qOverload<>(&QTimer::start));
+  connect(&searchTimer, &QTimer::timeout, this, [this] {
+    if (usersModel->SetSearchText(ui->searchEdit->text().trimmed())) {
+      Reload();
+    }
+  });
 
   Reload();
 }
 
 void UserListWidget::Reload()
 {
-  try {
-    userDataList = UserModel::LoadUsers();
-  }
-  catch (std::exception& ex) {
-    QMessageBox::critical(this, "Error", ex.what());
-    userDataList .clear();
-    ui->userTable->setRowCount(0);
-    return;
-  }
-
-  ui->userTable->setRowCount(userDataList.size());
-
-  for (int row = 0; row < ui->userTable->rowCount(); ++row) {
-    auto& elem = userDataList[row];
-
-    ui->userTable->setItem(row, 0, new QTableWidgetItem(elem.username));
-    ui->userTable->setItem(row, 1, new QTableWidgetItem(elem.name));
-    ui->userTable->setItem(row, 2, new QTableWidgetItem(elem.registrationDate.toString("yyyy-MM-dd hh:ss:mm")));
-  }
+  usersModel->Reload();
 }
 
 void UserListWidget::ShowTableContextMenu(const QPoint &p)
 {
-  auto item = ui->userTable->itemAt(p);
-  if (!item) {
+  auto index = ui->userTable->indexAt(p);
+  if (!index.isValid() || index.row() >= usersModel->rowCount()) {
     return;
   }
 
-  auto index = ui->userTable->indexFromItem(item);
-  if (index.row() < 0 || index.row() >= userDataList.size()) {
-    return;
-  }
+  auto selectedUserId = usersModel->RowAt(index.row()).id;
+
+  DatabasePool::Deliver(
+    DatabasePool::Run([user = user, selectedUserId] {
+      ContextMenuState state;
+      state.selectedUserId = selectedUserId;
+
+      state.canChangeAcceptCompanyRequest = UserPermissionModel::CanGrantOrRevokePermission(user, UserPermissionModel::PermissionID::AcceptCompanyRequest);
+      if (state.canChangeAcceptCompanyRequest) {
+        state.hasAcceptCompanyRequest = UserPermissionModel::HasPermission(selectedUserId, UserPermissionModel::PermissionID::AcceptCompanyRequest);
+      }
+
+      for (auto& company : CompanyModel::LoadCompaniesAdministratedBy(user.GetUserID())) {
+        auto& companyState = state.companies.emplace_back();
+
+        companyState.id = company.id;
+        companyState.companyName = company.companyName;
+        companyState.hasWorkWithOpenings = CompanyPermissionModel::HasPermission(selectedUserId, company.id, CompanyPermissionModel::PermissionID::WorkWithOpenings);
+      }
+      return state;
+    }),
+    this,
+    [this, p] (ContextMenuState state) {
+      ShowContextMenu(p, state);
+    },
+    [this] (QString error) {
+      QMessageBox::critical(this, "Error", error);
+    });
+}
 
-  auto& selectedUser = userDataList[index.row()];
+void UserListWidget::ShowContextMenu(
+  const QPoint &p,
+  const ContextMenuState& state
+)
+{
+  auto selectedUserId = state.selectedUserId;
 
   std::vector<std::unique_ptr<QAction>> userPermissionsActions;
-  if (UserPermissionModel::CanGrantOrRevokePermission(user.GetUserID(), UserPermissionModel::PermissionID::AcceptCompanyRequest)) {
+  if (state.canChangeAcceptCompanyRequest) {
     userPermissionsActions.push_back(std::make_unique<QAction>("View, accept and deny createCompanyRequest", ui->userTable));
     auto& action = userPermissionsActions.back();
 
-    bool hasPermission = UserPermissionModel::HasPermission(selectedUser.id, UserPermissionModel::PermissionID::AcceptCompanyRequest);
     action->setCheckable(true);
-    action->setChecked(hasPermission);
-
-    auto selectedUserId = selectedUser.id;
+    action->setChecked(state.hasAcceptCompanyRequest);
 
     connect(action.get(), &QAction::triggered, [this, selectedUserId] (bool set) {
-      try {
+      RunPermissionChange([user = user, selectedUserId, set] {
         if (set) {
           UserPermissionModel::GrantPermission(user, selectedUserId, UserPermissionModel::PermissionID::AcceptCompanyRequest);
-          QMessageBox::information(this, "Info", "Permission granted");
         }
         else {
           UserPermissionModel::RevokePermission(user, selectedUserId, UserPermissionModel::PermissionID::AcceptCompanyRequest);
-          QMessageBox::information(this, "Info", "Permission revoken");
         }
-        Reload();
-      }
-      catch (std::exception& ex) {
-        QMessageBox::critical(this, "Error", ex.what());
-      }
+      }, set);
     });
   }
 
   std::vector<std::unique_ptr<QAction>> workWithOpeningsActions;
-  for (auto& company : CompanyModel::LoadCompaniesAdministratedBy(user.GetUserID())) {
+  for (auto& company : state.companies) {
     workWithOpeningsActions.push_back(std::make_unique<QAction>(company.companyName, ui->userTable));
     auto& action = workWithOpeningsActions.back();
 
-    bool hasPermission = CompanyPermissionModel::HasPermission(selectedUser.id, company.id, CompanyPermissionModel::PermissionID::WorkWithOpenings);
     action->setCheckable(true);
-    action->setChecked(hasPermission);
+    action->setChecked(company.hasWorkWithOpenings);
 
     auto companyId = company.id;
-    auto selectedUserId = selectedUser.id;
     connect(action.get(), &QAction::triggered, [this, companyId, selectedUserId] (bool set) {
-      try {
+      RunPermissionChange([user = user, selectedUserId, companyId, set] {
         if (set) {
           CompanyPermissionModel::GrantPermission(user, selectedUserId, companyId, CompanyPermissionModel::PermissionID::WorkWithOpenings);
-          QMessageBox::information(this, "Info", "Permission granted");
         }
         else {
           CompanyPermissionModel::RevokePermission(user, selectedUserId, companyId, CompanyPermissionModel::PermissionID::WorkWithOpenings);
-          QMessageBox::information(this, "Info", "Permission revoken");
         }
-        Reload();
-      }
-      catch (std::exception& ex) {
-        QMessageBox::critical(this, "Error", ex.what());
-      }
+      }, set);
     });
   }
 
@@ -162,6 +168,23 @@ void UserListWidget::ShowTableContextMenu(const QPoint &p)
   menu.exec(p);
 }
 
+void UserListWidget::RunPermissionChange(
+  std::function<void()> change,
+  bool set
+)
+{
+  DatabasePool::Deliver(
+    DatabasePool::Run(std::move(change)),
+    this,
+    [this, set] {
+      QMessageBox::information(this, "Info", set ? "Permission granted" : "Permission revoken");
+      Reload();
+    },
+    [this] (QString error) {
+      QMessageBox::critical(this, "Error", error);
+    });
+}
+
 UserListWidget::~UserListWidget()
 {
   delete ui;
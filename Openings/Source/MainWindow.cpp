@@ -15,10 +15,13 @@
 #include "JobOpeningDialog.h"
 
 #include "UserPermissionModel.h"
+#include "JobOpeningModel.h"
+#include "DatabasePool.h"
 
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QMessageBox>
+#include <QFileDialog>
 
 #include <stdexcept>
 
@@ -43,8 +46,7 @@ bool MainWindow::Login()
   } while(!userPtr);
 
   ui->createCompanyRequestsButton->setHidden(
-    !UserPermissionModel::HasPermission(userPtr->GetUserID(),
-                                        UserPermissionModel::PermissionID::AcceptCompanyRequest)
+    !userPtr->Permissions()->HasUserPermission(UserPermissionModel::PermissionID::AcceptCompanyRequest)
   );
 
   return true;
@@ -252,3 +254,41 @@ void MainWindow::on_createOpening_released()
   widget->exec();
 }
 
+void MainWindow::on_importOpenings_released()
+{
+  auto fileName = QFileDialog::getOpenFileName(this,
+                                               "Import openings",
+                                               "",
+                                               "Openings (*.csv *.json)");
+  if (fileName.isEmpty()) {
+    return;
+  }
+
+  ui->importOpenings->setEnabled(false);
+  DatabasePool::Deliver(
+    JobOpeningModel::ImportJobOpeningsAsync(fileName, *userPtr),
+    this,
+    [this] (JobOpeningModel::JobOpeningImportReport report) {
+      ui->importOpenings->setEnabled(true);
+
+      QStringList rejected;
+      for (auto& rejection : report.rejected) {
+        rejected.append(QString("Record %1: %2").arg(rejection.record).arg(rejection.reason));
+      }
+
+      auto text = QString("Imported openings: %1, rejected: %2").arg(report.imported).arg(report.rejected.size());
+      QMessageBox box(rejected.isEmpty() ? QMessageBox::Information : QMessageBox::Warning,
+                      "Info",
+                      text,
+                      QMessageBox::Ok,
+                      this);
+      if (!rejected.isEmpty()) {
+        box.setDetailedText(rejected.join('\n'));
+      }
+      box.exec();
+    },
+    [this] (QString error) {
+      ui->importOpenings->setEnabled(true);
+      QMessageBox::critical(this, "Error", error);
+    });
+}
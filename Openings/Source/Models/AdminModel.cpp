@@ -1,18 +1,21 @@
 #include "AdminModel.h"
 
-#include <QSqlQuery>
+#include "StatementRegistry.h"
+#include "DatabasePool.h"
 #include <QSqlDatabase>
 
 #include <unordered_set>
 
 namespace AdminModel {
+  const QString canDealWithAdminRightsStatement = StatementRegistry::Declare(
+    "SELECT privilege_type "
+    "FROM information_schema.role_table_grants "
+    "WHERE table_name='openings_admin' "
+    "AND grantee=:username ");
+
   bool CanDealWithAdminRights() {
-    QSqlQuery query;
-    query.prepare( "SELECT privilege_type "
-                   "FROM information_schema.role_table_grants "
-                   "WHERE table_name='openings_admin' "
-                   "AND grantee=:username " );
-    query.bindValue(":username", QSqlDatabase::database().userName());
+    auto query = StatementRegistry::Prepare(canDealWithAdminRightsStatement);
+    query.bindValue(":username", DatabasePool::Database().userName());
     if (!query.exec()) {
       return false;
     }
@@ -28,35 +31,43 @@ namespace AdminModel {
         privs.count("UPDATE") == 1;
   }
 
+  const QString hasAdminRightStatement = StatementRegistry::Declare(
+    "SELECT id_user "
+    "FROM openings_admin "
+    "WHERE id_user = ?");
+
   bool HasAdminRight(
     UserID userId
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT id_user "
-                  "FROM openings_admin "
-                  "WHERE id_user = " + QString::number(userId));
+    auto query = StatementRegistry::Prepare(hasAdminRightStatement);
+    query.addBindValue(int(userId));
     return query.exec() && query.next();
   }
+
+  const QString grantAdminRightStatement = StatementRegistry::Declare(
+    "INSERT INTO openings_admin (id_user) "
+    "VALUES (?) "
+    "ON CONFLICT (id_user) DO NOTHING");
+
   bool GrantAdminRight(
     UserID userId
   )
   {
-    QSqlQuery query;
-    query.prepare("INSERT INTO openings_admin (id_user) "
-                  "VALUES (?) "
-                  "ON CONFLICT (id_user) DO NOTHING");
+    auto query = StatementRegistry::Prepare(grantAdminRightStatement);
     query.addBindValue(int(userId));
     return query.exec();
   }
 
+  const QString revokeAdminRightStatement = StatementRegistry::Declare(
+    "DELETE FROM openings_admin "
+    "WHERE id_user = ?");
+
   bool RevokeAdminRight(
     UserID userId
   )
   {
-    QSqlQuery query;
-    query.prepare("DELETE FROM openings_admin "
-                  "WHERE id_user = ?");
+    auto query = StatementRegistry::Prepare(revokeAdminRightStatement);
     query.addBindValue(int(userId));
     return query.exec();
   }
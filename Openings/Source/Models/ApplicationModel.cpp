@@ -5,12 +5,15 @@
 
 #include "JobOpeningModel.h"
 
-#include <QSqlQuery>
+#include "StatementRegistry.h"
+#include "DatabasePool.h"
 #include <QSqlError>
 
+#include <unordered_map>
+
 namespace ApplicationModel {
   void EnsureIsCreatorOfResume(UserResumeID resumeId, UserID userId) {
-    auto resume = UserResumeModel::LoadUserResume(resumeId);
+    auto resume = UserResumeModel::LoadUserResumeInfo(resumeId);
     if (!resume) {
       throw std::runtime_error("Cannot load application with specified id");
     }
@@ -19,19 +22,28 @@ namespace ApplicationModel {
     }
   };
 
-  void EnsureCanManageOpening(JobOpeningID OpeningId, UserID userId) {
+  void EnsureCanManageOpening(JobOpeningID OpeningId, const AuthenticatedUser& user) {
     auto opening = JobOpeningModel::LoadJobOpeningById(OpeningId);
     if (!opening) {
       throw std::runtime_error("Cannot load job opening with specified id");
     }
 
-    if( !CompanyPermissionModel::HasPermission(userId,
-                                               opening->companyId,
-                                               CompanyPermissionModel::PermissionID::WorkWithOpenings)) {
+    if( !user.Permissions()->HasCompanyPermission(opening->companyId,
+                                                  CompanyPermissionModel::PermissionID::WorkWithOpenings)) {
       throw std::runtime_error("You cannot manage this opening's application");
     }
   };
 
+  const QString postApplicationStatement = StatementRegistry::Declare(
+    "INSERT INTO openings_job_opening_application "
+    "(id_resume, "
+    " id_opening, "
+    " id_status_changer) "
+    "VALUES "
+    "(:id_resume, "
+    " :id_opening, "
+    " :id_status_changer) ");
+
   void PostApplication(
     const PostApplicationData& data,
     AuthenticatedUser user
@@ -39,15 +51,7 @@ namespace ApplicationModel {
   {
     EnsureIsCreatorOfResume(data.resumeId, user.GetUserID());
 
-    QSqlQuery query;
-    query.prepare("INSERT INTO openings_job_opening_application "
-                  "(id_resume, "
-                  " id_opening, "
-                  " id_status_changer) "
-                  "VALUES "
-                  "(:id_resume, "
-                  " :id_opening, "
-                  " :id_status_changer) ");
+    auto query = StatementRegistry::Prepare(postApplicationStatement);
     query.bindValue(":id_resume", int(data.resumeId));
     query.bindValue(":id_opening", int(data.openingId));
     query.bindValue(":id_status_changer", int(user.GetUserID()));
@@ -57,65 +61,189 @@ namespace ApplicationModel {
     }
   }
 
-  void EnsureCanCancelApplication(
-    const ApplicationData& data,
-    AuthenticatedUser user
-  )
-  {
-    EnsureIsCreatorOfResume(data.resumeId, user.GetUserID());
+  namespace  {
+    // Reason why the guarded update below did not match a row.
+    const char* TransitionError(
+      ApplicationAction action,
+      ApplicationStatusID status,
+      bool isApplicant,
+      bool canManageOpening
+    )
+    {
+      if (action == ApplicationAction::Cancel && !isApplicant) {
+        return "It's not your resume";
+      }
+      if (action != ApplicationAction::Cancel && !canManageOpening) {
+        return "You cannot manage this opening's application";
+      }
 
-    switch (data.status) {
-      case ApplicationModel::ApplicationStatusID::Cancelled:
-        throw std::runtime_error("Already cancelled");
+      switch (action) {
+        case ApplicationAction::Cancel:
+          switch (status) {
+            case ApplicationStatusID::Cancelled:
+              return "Already cancelled";
+            case ApplicationStatusID::Accepted: [[fallthrough]];
+            case ApplicationStatusID::Denied:
+              return "Cannot cancell already proceeded application";
+            case ApplicationStatusID::Posted:
+              break;
+          }
+          break;
+
+        case ApplicationAction::Accept:
+          switch (status) {
+            case ApplicationStatusID::Cancelled:
+              return "Cannot accept already cancelled application";
+            case ApplicationStatusID::Accepted:
+              return "Already accepted";
+            case ApplicationStatusID::Denied: [[fallthrough]];
+            case ApplicationStatusID::Posted:
+              break;
+          }
+          break;
+
+        case ApplicationAction::Deny:
+          switch (status) {
+            case ApplicationStatusID::Cancelled:
+              return "Cannot deny already cancelled application";
+            case ApplicationStatusID::Accepted:
+              return "Cannot deny already accepted application";
+            case ApplicationStatusID::Denied:
+              return "Already denied";
+            case ApplicationStatusID::Posted:
+              break;
+          }
+          break;
+      }
 
-      case ApplicationModel::ApplicationStatusID::Accepted: [[fallthrough]];
-      case ApplicationModel::ApplicationStatusID::Denied:
-        throw std::runtime_error("Cannot cancell already proceeded application");
+      // The row was eligible in the statement snapshot, but another
+      // reviewer changed it before our update got the row lock.
+      return "Application status was changed by someone else";
+    }
 
-      case ApplicationModel::ApplicationStatusID::Posted:
-        break;
+    // Moves the listed applications that are in one of the from statuses
+    // to target, when the user is the applicant or, for byApplicant
+    // false, may manage the opening. Every listed id comes back with its
+    // previous status, both checks and whether it was updated.
+    QString TransitionSql(
+      ApplicationStatusID target,
+      const QList<ApplicationStatusID>& from,
+      bool byApplicant
+    )
+    {
+      QStringList fromStatuses;
+      for (auto status : from) {
+        fromStatuses.append(QString::number(int(status)));
+      }
+
+      return
+        "WITH target AS ( "
+        " SELECT "
+        "  A.id, "
+        "  A.application_status, "
+        "  R.id_user=:id_user AS is_applicant, "
+        "  EXISTS (SELECT 1 "
+        "          FROM openings_user_to_company_permission AS P "
+        "          WHERE P.id_user=:id_user "
+        "            AND P.id_company=O.id_company "
+        "            AND P.id_permission=:id_permission) AS can_manage "
+        " FROM openings_job_opening_application AS A "
+        " JOIN openings_user_resume AS R ON R.id=A.id_resume "
+        " JOIN openings_job_opening AS O ON O.id=A.id_opening "
+        " WHERE A.id=ANY(CAST(:ids AS integer[])) "
+        "), updated AS ( "
+        " UPDATE openings_job_opening_application AS A "
+        " SET "
+        "  id_status_changer=:id_user, "
+        "  status_change_date=CURRENT_TIMESTAMP, "
+        "  application_status=" + QString::number(int(target)) + " "
+        " FROM target AS T "
+        " WHERE A.id=T.id "
+        "   AND T." + (byApplicant ? "is_applicant" : "can_manage") + " "
+        "   AND A.application_status IN (" + fromStatuses.join(", ") + ") "
+        " RETURNING A.id "
+        ") "
+        "SELECT "
+        " T.id, " // 0
+        " T.application_status, " // 1
+        " T.is_applicant, " // 2
+        " T.can_manage, " // 3
+        " EXISTS (SELECT 1 FROM updated AS U WHERE U.id=T.id) " // 4
+        "FROM target AS T";
     }
   }
 
-  void EnsureCanAcceptApplication(
-    const ApplicationData& data,
-    AuthenticatedUser user
-  )
-  {
-    EnsureCanManageOpening(data.openingId, user.GetUserID());
+  const QString cancelApplicationsStatement = StatementRegistry::Declare(
+    TransitionSql(ApplicationStatusID::Cancelled, {ApplicationStatusID::Posted}, true));
 
-    switch (data.status) {
-      case ApplicationModel::ApplicationStatusID::Cancelled:
-        throw std::runtime_error("Cannot accept already cancelled application");
+  const QString acceptApplicationsStatement = StatementRegistry::Declare(
+    TransitionSql(ApplicationStatusID::Accepted, {ApplicationStatusID::Posted, ApplicationStatusID::Denied}, false));
 
-      case ApplicationModel::ApplicationStatusID::Accepted:
-        throw std::runtime_error("Already accepted");
+  const QString denyApplicationsStatement = StatementRegistry::Declare(
+    TransitionSql(ApplicationStatusID::Denied, {ApplicationStatusID::Posted}, false));
 
-      case ApplicationModel::ApplicationStatusID::Denied: [[fallthrough]];
-      case ApplicationModel::ApplicationStatusID::Posted:
-        break;
-    }
-  }
-
-  void EnsureCanDenyApplication(
-    const ApplicationData& data,
+  QList<BulkActionResult<ApplicationID>> ApplyTransition(
+    ApplicationAction action,
+    const QList<ApplicationID>& ids,
     AuthenticatedUser user
   )
   {
-    EnsureCanManageOpening(data.openingId, user.GetUserID());
+    QList<BulkActionResult<ApplicationID>> results;
+    if (ids.isEmpty()) {
+      return results;
+    }
 
-    switch (data.status) {
-      case ApplicationModel::ApplicationStatusID::Cancelled:
-        throw std::runtime_error("Cannot deny already cancelled application");
+    const QString* statement = nullptr;
+    switch (action) {
+      case ApplicationAction::Cancel: statement = &cancelApplicationsStatement; break;
+      case ApplicationAction::Accept: statement = &acceptApplicationsStatement; break;
+      case ApplicationAction::Deny: statement = &denyApplicationsStatement; break;
+    }
 
-      case ApplicationModel::ApplicationStatusID::Accepted:
-        throw std::runtime_error("Cannot deny already accepted application");
+    // Each statement reads the applications with the facts needed for the
+    // checks and updates the eligible ones, in one round trip. The status
+    // is rechecked on the locked rows, so concurrent reviewers cannot both
+    // win, and the single statement is applied atomically.
+    auto query = StatementRegistry::Prepare(*statement);
+    query.bindValue(":ids", StatementRegistry::IntArray(ids));
+    query.bindValue(":id_user", int(user.GetUserID()));
+    query.bindValue(":id_permission", int(CompanyPermissionModel::PermissionID::WorkWithOpenings));
+    if (!query.exec()) {
+      throw std::runtime_error("Error while changing application statuses.\n" +
+                               query.lastError().text().toStdString());
+    }
 
-      case ApplicationModel::ApplicationStatusID::Denied:
-        throw std::runtime_error("Already denied");
+    std::unordered_map<ApplicationID, QString> errors;
+    errors.reserve(ids.size());
+    while (query.next()) {
+      auto& error = errors[ApplicationID(query.value(0).toInt())];
+      if (!query.value(4).toBool()) {
+        error = TransitionError(action,
+                                ApplicationStatusID(query.value(1).toInt()),
+                                query.value(2).toBool(),
+                                query.value(3).toBool());
+      }
+    }
 
-      case ApplicationModel::ApplicationStatusID::Posted:
-        break;
+    results.reserve(ids.size());
+    for (auto id : ids) {
+      auto it = errors.find(id);
+      results.append({id, it != errors.end() ? it->second : "Cannot load application with specified id"});
+    }
+    return results;
+  }
+
+  namespace  {
+    void ApplyTransition(
+      ApplicationAction action,
+      ApplicationID id,
+      const AuthenticatedUser& user
+    )
+    {
+      auto result = ApplyTransition(action, QList<ApplicationID>{id}, user).front();
+      if (!result.error.isEmpty()) {
+        throw std::runtime_error(result.error.toStdString());
+      }
     }
   }
 
@@ -124,26 +252,7 @@ namespace ApplicationModel {
     AuthenticatedUser user
   )
   {
-    auto application = LoadApplicationByid(id, user);
-    if (!application) {
-      throw std::runtime_error("Cannot load application with specified id");
-    }
-    EnsureCanCancelApplication(*application, user);
-
-    QSqlQuery query;
-    query.prepare("UPDATE openings_job_opening_application "
-                  "SET "
-                  " id_status_changer=:id_user, "
-                  " status_change_date=CURRENT_TIMESTAMP, "
-                  " application_status=2 "
-                  "WHERE "
-                  " id=:id");
-    query.bindValue(":id", int(id));
-    query.bindValue(":id_user", int(user.GetUserID()));
-    if (!query.exec()) {
-      throw std::runtime_error("Error while cancelling an application.\n" +
-                               query.lastError().text().toStdString());
-    }
+    ApplyTransition(ApplicationAction::Cancel, id, user);
   }
 
   void AcceptApplication(
@@ -151,52 +260,104 @@ namespace ApplicationModel {
     AuthenticatedUser user
   )
   {
-    auto application = LoadApplicationByid(id, user);
-    if (!application) {
-      throw std::runtime_error("Cannot load application with specified id");
-    }
-    EnsureCanAcceptApplication(*application, user);
-
-    QSqlQuery query;
-    query.prepare("UPDATE openings_job_opening_application "
-                  "SET "
-                  " id_status_changer=:id_user, "
-                  " status_change_date=CURRENT_TIMESTAMP, "
-                  " application_status=3 "
-                  "WHERE "
-                  " id=:id");
-    query.bindValue(":id", int(id));
-    query.bindValue(":id_user", int(user.GetUserID()));
-    if (!query.exec()) {
-      throw std::runtime_error("Error while accepting an application.\n" +
-                               query.lastError().text().toStdString());
-    }
+    ApplyTransition(ApplicationAction::Accept, id, user);
   }
+
   void DenyApplication(
     ApplicationID id,
     AuthenticatedUser user
   )
   {
-    auto application = LoadApplicationByid(id, user);
-    if (!application) {
-      throw std::runtime_error("Cannot load application with specified id");
+    ApplyTransition(ApplicationAction::Deny, id, user);
+  }
+
+  ApplicationActions AllowedActions(
+    ApplicationStatusID status,
+    bool isApplicant,
+    bool canManageOpening
+  )
+  {
+    ApplicationActions actions;
+    switch (status) {
+      case ApplicationStatusID::Posted:
+        actions.setFlag(ApplicationAction::Cancel, isApplicant);
+        actions.setFlag(ApplicationAction::Accept, canManageOpening);
+        actions.setFlag(ApplicationAction::Deny, canManageOpening);
+        break;
+
+      case ApplicationStatusID::Denied:
+        actions.setFlag(ApplicationAction::Accept, canManageOpening);
+        break;
+
+      case ApplicationStatusID::Cancelled: [[fallthrough]];
+      case ApplicationStatusID::Accepted:
+        break;
     }
-    EnsureCanDenyApplication(*application, user);
-
-    QSqlQuery query;
-    query.prepare("UPDATE openings_job_opening_application "
-                  "SET "
-                  " id_status_changer=:id_user, "
-                  " status_change_date=CURRENT_TIMESTAMP, "
-                  " application_status=4 "
-                  "WHERE "
-                  " id=:id");
-    query.bindValue(":id", int(id));
-    query.bindValue(":id_user", int(user.GetUserID()));
+    return actions;
+  }
+
+  ApplicationActions AllowedActions(
+    const ApplicationListData& data,
+    const AuthenticatedUser& user
+  )
+  {
+    auto canManageOpening = user.Permissions()->HasCompanyPermission(data.companyId,
+                                                                     CompanyPermissionModel::PermissionID::WorkWithOpenings);
+    return AllowedActions(data.status, data.applicantId == user.GetUserID(), canManageOpening);
+  }
+
+  const QString loadAllowedActionsStatement = StatementRegistry::Declare(
+    "SELECT "
+    " A.id, " // 0
+    " A.application_status, " // 1
+    " R.id_user, " // 2
+    " O.id_company " // 3
+    "FROM openings_job_opening_application AS A "
+    "JOIN openings_user_resume AS R ON R.id=A.id_resume "
+    "JOIN openings_job_opening AS O ON O.id=A.id_opening "
+    "WHERE A.id=ANY(CAST(:ids AS integer[]))");
+
+  QList<ApplicationActions> LoadAllowedActions(
+    const QList<ApplicationID>& ids,
+    AuthenticatedUser user
+  )
+  {
+    QList<ApplicationActions> actions(ids.size());
+    if (ids.isEmpty()) {
+      return actions;
+    }
+
+    std::unordered_map<ApplicationID, QList<qsizetype>> positions; // repeated ids share the result
+    positions.reserve(ids.size());
+    for (qsizetype i = 0; i < ids.size(); ++i) {
+      positions[ids[i]].append(i);
+    }
+
+    auto query = StatementRegistry::Prepare(loadAllowedActionsStatement);
+    query.bindValue(":ids", StatementRegistry::IntArray(ids));
+    query.setForwardOnly(true);
     if (!query.exec()) {
-      throw std::runtime_error("Error while denying an application.\n" +
+      throw std::runtime_error("Error while loading allowed application actions.\n" +
                                query.lastError().text().toStdString());
     }
+
+    auto permissions = user.Permissions();
+    while (query.next()) {
+      auto it = positions.find(ApplicationID(query.value(0).toInt()));
+      if (it == positions.end()) {
+        continue;
+      }
+
+      auto canManageOpening = permissions->HasCompanyPermission(CompanyID(query.value(3).toInt()),
+                                                                CompanyPermissionModel::PermissionID::WorkWithOpenings);
+      auto rowActions = AllowedActions(ApplicationStatusID(query.value(1).toInt()),
+                                       UserID(query.value(2).toInt()) == user.GetUserID(),
+                                       canManageOpening);
+      for (auto i : it->second) {
+        actions[i] = rowActions;
+      }
+    }
+    return actions;
   }
 
   bool CanCancel(
@@ -204,9 +365,7 @@ namespace ApplicationModel {
     AuthenticatedUser user
   )
   {
-    try {EnsureCanCancelApplication(data, user);}
-    catch (...) {return false;}
-    return true;
+    return LoadAllowedActions({data.id}, user).front().testFlag(ApplicationAction::Cancel);
   }
 
   bool CanAccept(
@@ -214,9 +373,7 @@ namespace ApplicationModel {
     AuthenticatedUser user
   )
   {
-    try {EnsureCanAcceptApplication(data, user);}
-    catch (...) {return false;}
-    return true;
+    return LoadAllowedActions({data.id}, user).front().testFlag(ApplicationAction::Accept);
   }
 
   bool CanDeny(
@@ -224,27 +381,27 @@ namespace ApplicationModel {
     AuthenticatedUser user
   )
   {
-    try {EnsureCanDenyApplication(data, user);}
-    catch (...) {return false;}
-    return true;
+    return LoadAllowedActions({data.id}, user).front().testFlag(ApplicationAction::Deny);
   }
 
+  const QString loadApplicationByidStatement = StatementRegistry::Declare(
+    "SELECT "
+    " id, " // 0
+    " id_resume, " // 1
+    " id_opening, " // 2
+    " application_date, " // 3
+    " application_status, " // 4
+    " status_change_date, " // 5
+    " id_status_changer " // 6
+    "FROM openings_job_opening_application "
+    "WHERE id=:id");
+
   std::unique_ptr<ApplicationData> LoadApplicationByid(
     ApplicationID id,
     AuthenticatedUser user
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  " id, " // 0
-                  " id_resume, " // 1
-                  " id_opening, " // 2
-                  " application_date, " // 3
-                  " application_status, " // 4
-                  " status_change_date, " // 5
-                  " id_status_changer " // 6
-                  "FROM openings_job_opening_application "
-                  "WHERE id=:id");
+    auto query = StatementRegistry::Prepare(loadApplicationByidStatement);
     query.bindValue(":id", int(id));
     if (!query.exec()) {
       throw std::runtime_error("Error while loading an application.\n" +
@@ -275,7 +432,7 @@ namespace ApplicationModel {
     }
 
     try {
-      EnsureCanManageOpening(ptr->openingId, user.GetUserID());
+      EnsureCanManageOpening(ptr->openingId, user);
       return ptr;
     }
     catch (std::exception& ex) {
@@ -287,42 +444,12 @@ namespace ApplicationModel {
     }
   }
 
-  QList<ApplicationData> LoadApplicationsCreatedBy(
-    AuthenticatedUser user,
-    std::optional<ApplicationStatusID> status
-  )
-  {
-    QString queryStr("SELECT "
-                     " A.id, " // 0
-                     " A.id_resume, " // 1
-                     " A.id_opening, " // 2
-                     " A.application_date, " // 3
-                     " A.application_status, " // 4
-                     " A.status_change_date, " // 5
-                     " A.id_status_changer " // 6
-                     "FROM openings_job_opening_application as A "
-                     "JOIN openings_user_resume as R ON "
-                     "  R.id=A.id_resume "
-                     "WHERE R.id_user=:id_user ");
-    if (status.has_value()) {
-      queryStr += "AND A.application_status=:application_status";
-    }
-
-    QSqlQuery query;
-    query.prepare(queryStr);
-    query.bindValue(":id_user", int(user.GetUserID()));
-    if (status.has_value()) {
-      query.bindValue(":application_status", int(status.value()));
-    }
-    if (!query.exec()) {
-      throw std::runtime_error("Error while loading applications.\n" +
-                               query.lastError().text().toStdString());
-    }
-
-    QList<ApplicationData> dataList;
-    while (query.next()) {
-      auto& data = dataList.emplace_back();
-
+  namespace  {
+    void ReadApplicationData(
+      const StatementRegistry::Statement& query,
+      ApplicationData& data
+    )
+    {
       data.id = ApplicationID(query.value(0).toInt());
       data.resumeId = UserResumeID(query.value(1).toInt());
       data.openingId = JobOpeningID(query.value(2).toInt());
@@ -331,7 +458,131 @@ namespace ApplicationModel {
       data.statusChangeDate = query.value(5).toDateTime();
       data.statusChangerID = UserID(query.value(6).toInt());
     }
-    return dataList;
+
+    void ReadApplicationListData(
+      const StatementRegistry::Statement& query,
+      ApplicationListData& data
+    )
+    {
+      ReadApplicationData(query, data);
+      data.jobTitle = query.value(7).toString();
+      data.companyId = CompanyID(query.value(8).toInt());
+      data.companyName = query.value(9).toString();
+      data.applicantId = UserID(query.value(10).toInt());
+      data.applicantUsername = query.value(11).toString();
+      data.statusChangerUsername = query.value(12).toString();
+    }
+
+    // Whose applications a list statement selects: the low bit of the
+    // index of the declared variant. The next bit is the status filter.
+    enum ApplicationOwner {
+      CreatedBy = 0,
+      ForOpeningsCreatedBy = 1,
+    };
+
+    constexpr int byStatus = 2;
+
+    const QStringList loadApplicationsStatements = StatementRegistry::DeclareVariants(2, [] (int mask) {
+      QString sql("SELECT "
+                  " A.id, " // 0
+                  " A.id_resume, " // 1
+                  " A.id_opening, " // 2
+                  " A.application_date, " // 3
+                  " A.application_status, " // 4
+                  " A.status_change_date, " // 5
+                  " A.id_status_changer " // 6
+                  "FROM openings_job_opening_application as A ");
+      if (mask & ForOpeningsCreatedBy) {
+        sql += "JOIN openings_job_opening as O "
+               "ON O.id=A.id_opening "
+               "WHERE O.id_creator=:id_user ";
+      }
+      else {
+        sql += "JOIN openings_user_resume as R ON "
+               "  R.id=A.id_resume "
+               "WHERE R.id_user=:id_user ";
+      }
+      if (mask & byStatus) {
+        sql += "AND A.application_status=:application_status";
+      }
+      return sql;
+    });
+
+    const QStringList loadApplicationListStatements = StatementRegistry::DeclareVariants(2, [] (int mask) {
+      QString sql("SELECT "
+                  " A.id, " // 0
+                  " A.id_resume, " // 1
+                  " A.id_opening, " // 2
+                  " A.application_date, " // 3
+                  " A.application_status, " // 4
+                  " A.status_change_date, " // 5
+                  " A.id_status_changer, " // 6
+                  " O.title, " // 7
+                  " O.id_company, " // 8
+                  " C.name, " // 9
+                  " R.id_user, " // 10
+                  " AU.username, " // 11
+                  " SU.username " // 12
+                  "FROM openings_job_opening_application AS A "
+                  "JOIN openings_job_opening AS O ON O.id=A.id_opening "
+                  "JOIN openings_user_resume AS R ON R.id=A.id_resume "
+                  "LEFT JOIN openings_company AS C ON C.id=O.id_company "
+                  "LEFT JOIN openings_user AS AU ON AU.id=R.id_user "
+                  "LEFT JOIN openings_user AS SU ON SU.id=A.id_status_changer ");
+      sql += (mask & ForOpeningsCreatedBy) ? "WHERE O.id_creator=:id_user "
+                                           : "WHERE R.id_user=:id_user ";
+      if (mask & byStatus) {
+        sql += "AND A.application_status=:application_status";
+      }
+      return sql;
+    });
+
+    StatementRegistry::Statement ExecuteApplicationsStatement(
+      const QStringList& variants,
+      ApplicationOwner owner,
+      AuthenticatedUser user,
+      std::optional<ApplicationStatusID> status
+    )
+    {
+      auto query = StatementRegistry::Prepare(variants[owner | (status.has_value() ? byStatus : 0)]);
+      query.bindValue(":id_user", int(user.GetUserID()));
+      if (status.has_value()) {
+        query.bindValue(":application_status", int(status.value()));
+      }
+      query.setForwardOnly(true);
+      if (!query.exec()) {
+        throw std::runtime_error("Error while loading applications.\n" +
+                                 query.lastError().text().toStdString());
+      }
+      return query;
+    }
+
+    StatementRegistry::Statement ExecuteLoadApplications(
+      ApplicationOwner owner,
+      AuthenticatedUser user,
+      std::optional<ApplicationStatusID> status
+    )
+    {
+      return ExecuteApplicationsStatement(loadApplicationsStatements, owner, user, status);
+    }
+
+    StatementRegistry::Statement ExecuteLoadApplicationList(
+      ApplicationOwner owner,
+      AuthenticatedUser user,
+      std::optional<ApplicationStatusID> status
+    )
+    {
+      return ExecuteApplicationsStatement(loadApplicationListStatements, owner, user, status);
+    }
+  }
+
+  QList<ApplicationData> LoadApplicationsCreatedBy(
+    AuthenticatedUser user,
+    std::optional<ApplicationStatusID> status
+  )
+  {
+    auto query = ExecuteLoadApplications(CreatedBy, user, status);
+    return StatementRegistry::ReadRows<ApplicationData>(query, ReadApplicationData);
   }
 
   QList<ApplicationData> LoadApplicationsForOpeningsCreatedBy(
@@ -339,45 +590,136 @@ namespace ApplicationModel {
     std::optional<ApplicationStatusID> status
   )
   {
-    QString queryStr("SELECT "
-                     " A.id, " // 0
-                     " A.id_resume, " // 1
-                     " A.id_opening, " // 2
-                     " A.application_date, " // 3
-                     " A.application_status, " // 4
-                     " A.status_change_date, " // 5
-                     " A.id_status_changer " // 6
-                     "FROM openings_job_opening_application as A "
-                     "JOIN openings_job_opening as O "
-                     "ON O.id=A.id_opening "
-                     "WHERE O.id_creator=:id_user ");
-    if (status.has_value()) {
-      queryStr += "AND A.application_status=:application_status";
-    }
+    auto query = ExecuteLoadApplications(ForOpeningsCreatedBy, user, status);
+    return StatementRegistry::ReadRows<ApplicationData>(query, ReadApplicationData);
+  }
 
-    QSqlQuery query;
-    query.prepare(queryStr);
-    query.bindValue(":id_user", int(user.GetUserID()));
-    if (status.has_value()) {
-      query.bindValue(":application_status", int(status.value()));
-    }
-    if (!query.exec()) {
-      throw std::runtime_error("Error while loading applications.\n" +
-                               query.lastError().text().toStdString());
-    }
+  void VisitApplicationsCreatedBy(
+    AuthenticatedUser user,
+    std::optional<ApplicationStatusID> status,
+    const RowVisitor<ApplicationData>& visitor
+  )
+  {
+    auto query = ExecuteLoadApplications(CreatedBy, user, status);
+    StatementRegistry::VisitRows<ApplicationData>(query, ReadApplicationData, visitor);
+  }
 
-    QList<ApplicationData> dataList;
-    while (query.next()) {
-      auto& data = dataList.emplace_back();
+  void VisitApplicationsForOpeningsCreatedBy(
+    AuthenticatedUser user,
+    std::optional<ApplicationStatusID> status,
+    const RowVisitor<ApplicationData>& visitor
+  )
+  {
+    auto query = ExecuteLoadApplications(ForOpeningsCreatedBy, user, status);
+    StatementRegistry::VisitRows<ApplicationData>(query, ReadApplicationData, visitor);
+  }
 
-      data.id = ApplicationID(query.value(0).toInt());
-      data.resumeId = UserResumeID(query.value(1).toInt());
-      data.openingId = JobOpeningID(query.value(2).toInt());
-      data.applicationDate = query.value(3).toDateTime();
-      data.status = ApplicationStatusID(query.value(4).toInt());
-      data.statusChangeDate = query.value(5).toDateTime();
-      data.statusChangerID = UserID(query.value(6).toInt());
-    }
-    return dataList;
+  QList<ApplicationListData> LoadApplicationListCreatedBy(
+    AuthenticatedUser user,
+    std::optional<ApplicationStatusID> status
+  )
+  {
+    auto query = ExecuteLoadApplicationList(CreatedBy, user, status);
+    return StatementRegistry::ReadRows<ApplicationListData>(query, ReadApplicationListData);
+  }
+
+  QList<ApplicationListData> LoadApplicationListForOpeningsCreatedBy(
+    AuthenticatedUser user,
+    std::optional<ApplicationStatusID> status
+  )
+  {
+    auto query = ExecuteLoadApplicationList(ForOpeningsCreatedBy, user, status);
+    return StatementRegistry::ReadRows<ApplicationListData>(query, ReadApplicationListData);
+  }
+
+  void VisitApplicationListCreatedBy(
+    AuthenticatedUser user,
+    std::optional<ApplicationStatusID> status,
+    const RowVisitor<ApplicationListData>& visitor
+  )
+  {
+    auto query = ExecuteLoadApplicationList(CreatedBy, user, status);
+    StatementRegistry::VisitRows<ApplicationListData>(query, ReadApplicationListData, visitor);
+  }
+
+  void VisitApplicationListForOpeningsCreatedBy(
+    AuthenticatedUser user,
+    std::optional<ApplicationStatusID> status,
+    const RowVisitor<ApplicationListData>& visitor
+  )
+  {
+    auto query = ExecuteLoadApplicationList(ForOpeningsCreatedBy, user, status);
+    StatementRegistry::VisitRows<ApplicationListData>(query, ReadApplicationListData, visitor);
+  }
+
+  QFuture<std::optional<ApplicationData>> LoadApplicationByidAsync(
+    ApplicationID id,
+    AuthenticatedUser user
+  )
+  {
+    return DatabasePool::Run([id, user] {
+      return DatabasePool::TakeOptional(LoadApplicationByid(id, user));
+    });
+  }
+
+  QFuture<QList<ApplicationActions>> LoadAllowedActionsAsync(
+    QList<ApplicationID> ids,
+    AuthenticatedUser user
+  )
+  {
+    return DatabasePool::Run([ids = std::move(ids), user] {
+      return LoadAllowedActions(ids, user);
+    });
+  }
+
+  QFuture<QList<BulkActionResult<ApplicationID>>> ApplyTransitionAsync(
+    ApplicationAction action,
+    QList<ApplicationID> ids,
+    AuthenticatedUser user
+  )
+  {
+    return DatabasePool::Run([action, ids = std::move(ids), user] {
+      return ApplyTransition(action, ids, user);
+    });
+  }
+
+  QFuture<QList<ApplicationData>> LoadApplicationsCreatedByAsync(
+    AuthenticatedUser user,
+    std::optional<ApplicationStatusID> status
+  )
+  {
+    return DatabasePool::Run([user, status] {
+      return LoadApplicationsCreatedBy(user, status);
+    });
+  }
+
+  QFuture<QList<ApplicationData>> LoadApplicationsForOpeningsCreatedByAsync(
+    AuthenticatedUser user,
+    std::optional<ApplicationStatusID> status
+  )
+  {
+    return DatabasePool::Run([user, status] {
+      return LoadApplicationsForOpeningsCreatedBy(user, status);
+    });
+  }
+
+  QFuture<QList<ApplicationListData>> LoadApplicationListCreatedByAsync(
+    AuthenticatedUser user,
+    std::optional<ApplicationStatusID> status
+  )
+  {
+    return DatabasePool::Run([user, status] {
+      return LoadApplicationListCreatedBy(user, status);
+    });
+  }
+
+  QFuture<QList<ApplicationListData>> LoadApplicationListForOpeningsCreatedByAsync(
+    AuthenticatedUser user,
+    std::optional<ApplicationStatusID> status
+  )
+  {
+    return DatabasePool::Run([user, status] {
+      return LoadApplicationListForOpeningsCreatedBy(user, status);
+    });
   }
 }
@@ -2,20 +2,59 @@
 
 #include "UserPermissionModel.h"
 
-#include <QSqlQuery>
+#include "StatementRegistry.h"
+#include "DatabasePool.h"
+
+namespace  {
+  auto& CompanyCache() {
+    static EntityCache<CompanyID, CompanyModel::CompanyData> cache(1024, std::chrono::minutes(30));
+    return cache;
+  }
+
+  void ReadCompanyData(
+    const StatementRegistry::Statement& query,
+    CompanyModel::CompanyData& data
+  )
+  {
+    data.id = CompanyID(query.value(0).toInt());
+    data.companyName = query.value(1).toString();
+    data.companyAdmin = UserID(query.value(2).toInt());
+  }
+
+  void ReadCreateCompanyRequestData(
+    const StatementRegistry::Statement& query,
+    CompanyModel::CreateCompanyRequestData& data
+  )
+  {
+    data.id = CreateCompanyRequestID(query.value(0).toInt());
+    data.companyName = query.value(1).toString();
+    data.requesterId = UserID(query.value(2).toInt());
+    data.requestDate = query.value(3).toDateTime();
+    data.status = CreateCompanyRequestStatus(query.value(4).toInt());
+    data.statusChangeDate = query.value(5).toDateTime();
+    data.statusChangerId = UserID(query.value(6).toInt());
+  }
+}
 
 namespace CompanyModel {
+  const QString findPostedCreateCompanyRequestStatement = StatementRegistry::Declare(
+    "SELECT id "
+    "FROM openings_create_company_request "
+    "WHERE company_name=:company_name "
+    "AND id_requester=:id_requester "
+    "AND request_status=:request_status");
+
+  const QString requestCreateCompanyStatement = StatementRegistry::Declare(
+    "INSERT INTO openings_create_company_request "
+    "(company_name, id_requester, id_status_changer) "
+    "VALUES(:company_name, :id_requester, :id_requester)");
+
   void RequestCreateCompany(
     QString companyName,
     const AuthenticatedUser& requester
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT id "
-                  "FROM openings_create_company_request "
-                  "WHERE company_name=:company_name "
-                  "AND id_requester=:id_requester "
-                  "AND request_status=:request_status");
+    auto query = StatementRegistry::Prepare(findPostedCreateCompanyRequestStatement);
     query.bindValue(":company_name", companyName);
     query.bindValue(":id_requester", int(requester.GetUserID()));
     query.bindValue(":request_status", int(CreateCompanyRequestStatus::Posted));
@@ -27,17 +66,24 @@ namespace CompanyModel {
       throw std::runtime_error("You have already created a query. Your query is in process");
     }
 
-    query.prepare("INSERT INTO openings_create_company_request "
-                  "(company_name, id_requester, id_status_changer) "
-                  "VALUES(:company_name, :id_requester, :id_requester)");
-    query.bindValue(":company_name", companyName);
-    query.bindValue(":id_requester", int(requester.GetUserID()));
+    auto insertQuery = StatementRegistry::Prepare(requestCreateCompanyStatement);
+    insertQuery.bindValue(":company_name", companyName);
+    insertQuery.bindValue(":id_requester", int(requester.GetUserID()));
 
-    if (!query.exec()) {
+    if (!insertQuery.exec()) {
       throw std::runtime_error("Error while inserting create company query");
     }
   }
 
+  const QString cancelCreateCompanyRequestStatement = StatementRegistry::Declare(
+    "UPDATE openings_create_company_request "
+    "SET request_status=2, "
+    "    status_change_date=CURRENT_TIMESTAMP, "
+    "    id_status_changer=:id_requester "
+    "WHERE id=:id "
+    "AND id_requester=:id_requester "
+    "AND request_status=1");
+
   void CancelCreateCompanyRequest(
     CreateCompanyRequestID createCompanyReqId,
     const AuthenticatedUser& requester
@@ -63,14 +109,7 @@ namespace CompanyModel {
         break;
     }
 
-    QSqlQuery query;
-    query.prepare("UPDATE openings_create_company_request "
-                  "SET request_status=2, "
-                  "    status_change_date=CURRENT_TIMESTAMP, "
-                  "    id_status_changer=:id_requester "
-                  "WHERE id=:id "
-                  "AND id_requester=:id_requester "
-                  "AND request_status=1");
+    auto query = StatementRegistry::Prepare(cancelCreateCompanyRequestStatement);
     query.bindValue(":id", int(createCompanyReqId));
     query.bindValue(":id_requester", int(requester.GetUserID()));
     if (!query.exec()) {
@@ -78,6 +117,8 @@ namespace CompanyModel {
     }
   }
 
+  // Checks the database rather than the session snapshot, which may be
+  // older than a revocation.
   void EnsureCanChangeCreateCompanyRequestStatus(
     const AuthenticatedUser& admin
   )
@@ -88,12 +129,25 @@ namespace CompanyModel {
     }
   }
 
+  const QString insertCompanyStatement = StatementRegistry::Declare(
+    "INSERT INTO openings_company "
+    " (name, id_company_admin) "
+    "VALUES(:name, :id_company_admin)");
+
+  const QString acceptCreateCompanyRequestStatement = StatementRegistry::Declare(
+    "UPDATE openings_create_company_request "
+    "SET request_status=4, "
+    "    status_change_date=CURRENT_TIMESTAMP, "
+    "    id_status_changer=:id_status_changer "
+    "WHERE id=:id "
+    "AND request_status IN (1, 3)");
+
   void AcceptCreateCompanyRequest(
     CreateCompanyRequestID createCompanyReqId,
     const AuthenticatedUser& admin
   )
   {
-    QSqlDatabase::database().transaction();
+    DatabasePool::Transaction transaction(DatabasePool::Database());
     auto loaded = LoadCreateCompanyRequestData(createCompanyReqId);
     if (!loaded) {
       throw std::runtime_error("There is no create company request with such id");
@@ -110,30 +164,34 @@ namespace CompanyModel {
         break;
     }
 
-    QSqlQuery query;
-    query.prepare("INSERT INTO openings_company "
-                  " (name, id_company_admin) "
-                  "VALUES(:name, :id_company_admin)" );
-    query.bindValue(":name", loaded->companyName);
-    query.bindValue(":id_company_admin", int(loaded->requesterId));
-    if (!query.exec()) {
+    auto insertQuery = StatementRegistry::Prepare(insertCompanyStatement);
+    insertQuery.bindValue(":name", loaded->companyName);
+    insertQuery.bindValue(":id_company_admin", int(loaded->requesterId));
+    if (!insertQuery.exec()) {
       throw std::runtime_error("Error while inserting a company");
     }
 
-    query.prepare("UPDATE openings_create_company_request "
-                  "SET request_status=4, "
-                  "    status_change_date=CURRENT_TIMESTAMP, "
-                  "    id_status_changer=:id_status_changer "
-                  "WHERE id=:id "
-                  "AND request_status IN (1, 3)");
+    auto query = StatementRegistry::Prepare(acceptCreateCompanyRequestStatement);
     query.bindValue(":id", int(createCompanyReqId));
     query.bindValue(":id_status_changer", int(admin.GetUserID()));
     if (!query.exec()) {
       throw std::runtime_error("Error while accepting a create company request");
     }
-    QSqlDatabase::database().commit();
+    transaction.Commit();
+
+    if (loaded->requesterId == admin.GetUserID()) {
+      admin.RefreshPermissions();
+    }
   }
 
+  const QString denyCreateCompanyRequestStatement = StatementRegistry::Declare(
+    "UPDATE openings_create_company_request "
+    "SET request_status=3, "
+    "    status_change_date=CURRENT_TIMESTAMP, "
+    "    id_status_changer=:id_status_changer "
+    "WHERE id=:id "
+    "AND request_status=1");
+
   void DenyCreateCompanyRequest(
     CreateCompanyRequestID createCompanyReqId,
     const AuthenticatedUser& admin
@@ -158,13 +216,7 @@ namespace CompanyModel {
         break;
     }
 
-    QSqlQuery query;
-    query.prepare("UPDATE openings_create_company_request "
-                  "SET request_status=3, "
-                  "    status_change_date=CURRENT_TIMESTAMP, "
-                  "    id_status_changer=:id_status_changer "
-                  "WHERE id=:id "
-                  "AND request_status=1");
+    auto query = StatementRegistry::Prepare(denyCreateCompanyRequestStatement);
     query.bindValue(":id", int(createCompanyReqId));
     query.bindValue(":id_status_changer", int(admin.GetUserID()));
     if (!query.exec()) {
@@ -172,21 +224,23 @@ namespace CompanyModel {
     }
   }
 
+  const QString loadCreateCompanyRequestDataStatement = StatementRegistry::Declare(
+    "SELECT "
+    " id, " // 0
+    " company_name, " // 1
+    " id_requester, " // 2
+    " request_date, " // 3
+    " request_status, " // 4
+    " status_change_date, " // 5
+    " id_status_changer " // 6
+    "FROM openings_create_company_request "
+    "WHERE id=:id");
+
   std::unique_ptr<CreateCompanyRequestData> LoadCreateCompanyRequestData(
     CreateCompanyRequestID createCompanyReqId
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  " id, " // 0
-                  " company_name, " // 1
-                  " id_requester, " // 2
-                  " request_date, " // 3
-                  " request_status, " // 4
-                  " status_change_date, " // 5
-                  " id_status_changer " // 6
-                  "FROM openings_create_company_request "
-                  "WHERE id=:id" );
+    auto query = StatementRegistry::Prepare(loadCreateCompanyRequestDataStatement);
     query.bindValue(":id", int(createCompanyReqId));
     if (!query.exec()) {
       throw std::runtime_error("Error while loading create company request data");
@@ -207,17 +261,23 @@ namespace CompanyModel {
     return ptr;
   }
 
+  const QString loadCompanyDataByIdStatement = StatementRegistry::Declare(
+    "SELECT "
+    " id, " // 0
+    " name, " // 1
+    " id_company_admin " // 2
+    "FROM openings_company "
+    "WHERE id=?");
+
   std::unique_ptr<CompanyData> LoadCompanyDataById(
     CompanyID companyId
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  " id, " // 0
-                  " name, " // 1
-                  " id_company_admin " // 2
-                  "FROM openings_company "
-                  "WHERE id=?" );
+    if (auto cached = CompanyCache().Find(companyId)) {
+      return std::make_unique<CompanyData>(std::move(cached.value()));
+    }
+
+    auto query = StatementRegistry::Prepare(loadCompanyDataByIdStatement);
     query.addBindValue(int(companyId));
     if (!query.exec()) {
       throw std::runtime_error("Error while loading company data");
@@ -230,21 +290,25 @@ namespace CompanyModel {
       ptr->id = CompanyID(query.value(0).toInt());
       ptr->companyName = query.value(1).toString();
       ptr->companyAdmin = UserID(query.value(2).toInt());
+
+      CompanyCache().Insert(ptr->id, *ptr);
     }
     return ptr;
   }
 
+  const QString loadCompanyDataByNameStatement = StatementRegistry::Declare(
+    "SELECT "
+    " id, " // 0
+    " name, " // 1
+    " id_company_admin " // 2
+    "FROM openings_company "
+    "WHERE name=?");
+
   std::unique_ptr<CompanyData> LoadCompanyDataByName(
     QString companyName
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  " id, " // 0
-                  " name, " // 1
-                  " id_company_admin " // 2
-                  "FROM openings_company "
-                  "WHERE name=?" );
+    auto query = StatementRegistry::Prepare(loadCompanyDataByNameStatement);
     query.addBindValue(companyName);
     if (!query.exec()) {
       throw std::runtime_error("Error while loading company data");
@@ -261,123 +325,280 @@ namespace CompanyModel {
     return ptr;
   }
 
+  const QString loadCompaniesStatement = StatementRegistry::Declare(
+    "SELECT "
+    " id, " // 0
+    " name, " // 1
+    " id_company_admin " // 2
+    "FROM openings_company ");
+
+  namespace  {
+    StatementRegistry::Statement ExecuteLoadCompanies()
+    {
+      auto query = StatementRegistry::Prepare(loadCompaniesStatement);
+      query.setForwardOnly(true);
+      if (!query.exec()) {
+        throw std::runtime_error("Error while loading companies data");
+      }
+      return query;
+    }
+  }
+
   QList<CompanyData> LoadCompanies()
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  " id, " // 0
-                  " name, " // 1
-                  " id_company_admin " // 2
-                  "FROM openings_company ");
+    auto query = ExecuteLoadCompanies();
+    return StatementRegistry::ReadRows<CompanyData>(query, ReadCompanyData);
+  }
+
+  void VisitCompanies(
+    const RowVisitor<CompanyData>& visitor
+  )
+  {
+    auto query = ExecuteLoadCompanies();
+    StatementRegistry::VisitRows<CompanyData>(query, ReadCompanyData, visitor);
+  }
+
+  // The filter and the ordering both use the GiST trigram index on the
+  // name, which returns the closest rows first, so the first page reads
+  // about a page of matches. The cursor of the later pages can't be an
+  // index condition on the distance: the index scan starts from the
+  // closest match again, so page N reads the N pages before it too.
+  const QString searchFirstCompaniesStatement = StatementRegistry::Declare(
+    "SELECT "
+    " id, " // 0
+    " name, " // 1
+    " id_company_admin, " // 2
+    " distance " // 3
+    "FROM ("
+    " SELECT id, name, id_company_admin, name <->> :text AS distance"
+    " FROM openings_company"
+    " WHERE name %> :text"
+    ") AS matches "
+    "ORDER BY distance, id "
+    "LIMIT :limit ");
+
+  const QString searchCompaniesStatement = StatementRegistry::Declare(
+    "SELECT "
+    " id, " // 0
+    " name, " // 1
+    " id_company_admin, " // 2
+    " distance " // 3
+    "FROM ("
+    " SELECT id, name, id_company_admin, name <->> :text AS distance"
+    " FROM openings_company"
+    " WHERE name %> :text"
+    ") AS matches "
+    "WHERE (distance, id) > (CAST(:after_distance AS REAL), :after_id) "
+    "ORDER BY distance, id "
+    "LIMIT :limit ");
+
+  CompanySearchPage SearchCompanies(
+    QString text,
+    std::optional<CompanySearchCursor> after,
+    int limit
+  )
+  {
+    if (text.size() < TRIGRAM_SEARCH_MIN_SIZE) {
+      return CompanySearchPage();
+    }
+
+    auto query = StatementRegistry::Prepare(after.has_value() ? searchCompaniesStatement
+                                                              : searchFirstCompaniesStatement);
+    query.bindValue(":text", text);
+    if (after.has_value()) {
+      query.bindValue(":after_distance", double(after->distance));
+      query.bindValue(":after_id", int(after->id));
+    }
+    query.bindValue(":limit", limit);
+    query.setForwardOnly(true);
+
     if (!query.exec()) {
-      throw std::runtime_error("Error while loading companies data");
+      throw std::runtime_error("Error while searching companies");
     }
 
-    QList<CompanyData> dataList;
+    CompanySearchPage page;
+    page.rows.reserve(limit);
     while (query.next()) {
-      auto& data = dataList.emplace_back();
+      auto& data = page.rows.emplace_back();
+      ReadCompanyData(query, data);
+
+      page.next = CompanySearchCursor{float(query.value(3).toDouble()), data.id};
+    }
 
-      data.id = CompanyID(query.value(0).toInt());
-      data.companyName = query.value(1).toString();
-      data.companyAdmin = UserID(query.value(2).toInt());
+    if (page.rows.size() < limit) {
+      page.next.reset();
     }
-    return dataList;
+    return page;
   }
 
+  const QString loadCompaniesAdministratedByStatement = StatementRegistry::Declare(
+    "SELECT "
+    " id, " // 0
+    " name, " // 1
+    " id_company_admin " // 2
+    "FROM openings_company "
+    "WHERE id_company_admin=:id_company_admin ");
+
   QList<CompanyData> LoadCompaniesAdministratedBy(
     UserID userId
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  " id, " // 0
-                  " name, " // 1
-                  " id_company_admin " // 2
-                  "FROM openings_company "
-                  "WHERE id_company_admin=:id_company_admin ");
+    auto query = StatementRegistry::Prepare(loadCompaniesAdministratedByStatement);
     query.bindValue(":id_company_admin", int(userId));
+    query.setForwardOnly(true);
     if (!query.exec()) {
       throw std::runtime_error("Error while loading companies data");
     }
 
-    QList<CompanyData> dataList;
-    while (query.next()) {
-      auto& data = dataList.emplace_back();
+    return StatementRegistry::ReadRows<CompanyData>(query, ReadCompanyData);
+  }
 
-      data.id = CompanyID(query.value(0).toInt());
-      data.companyName = query.value(1).toString();
-      data.companyAdmin = UserID(query.value(2).toInt());
+  const QString loadCreateCompanyRequestsStatement = StatementRegistry::Declare(
+    "SELECT "
+    " id, " // 0
+    " company_name, " // 1
+    " id_requester, " // 2
+    " request_date, " // 3
+    " request_status, " // 4
+    " status_change_date, " // 5
+    " id_status_changer " // 6
+    "FROM openings_create_company_request");
+
+  namespace  {
+    StatementRegistry::Statement ExecuteLoadCreateCompanyRequests(
+      const AuthenticatedUser& admin
+    )
+    {
+      if( !admin.Permissions()->HasUserPermission(UserPermissionModel::PermissionID::AcceptCompanyRequest) ) {
+        throw std::runtime_error("You have no permission to accept company requests");
+      }
+
+      auto query = StatementRegistry::Prepare(loadCreateCompanyRequestsStatement);
+      query.setForwardOnly(true);
+      if (!query.exec()) {
+        throw std::runtime_error("Error while loading create company request data list");
+      }
+      return query;
     }
-    return dataList;
   }
 
   QList<CreateCompanyRequestData> LoadCreateCompanyRequests(
     const AuthenticatedUser& admin
   )
   {
-    EnsureCanChangeCreateCompanyRequestStatus(admin);
-
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  " id, " // 0
-                  " company_name, " // 1
-                  " id_requester, " // 2
-                  " request_date, " // 3
-                  " request_status, " // 4
-                  " status_change_date, " // 5
-                  " id_status_changer " // 6
-                  "FROM openings_create_company_request");
-    if (!query.exec()) {
-      throw std::runtime_error("Error while loading create company request data list");
-    }
-
-    QList<CreateCompanyRequestData> list;
-    while (query.next()) {
-      auto& newItem = list.emplace_back();
+    auto query = ExecuteLoadCreateCompanyRequests(admin);
+    return StatementRegistry::ReadRows<CreateCompanyRequestData>(query, ReadCreateCompanyRequestData);
+  }
 
-      newItem.id = CreateCompanyRequestID(query.value(0).toInt());
-      newItem.companyName = query.value(1).toString();
-      newItem.requesterId = UserID(query.value(2).toInt());
-      newItem.requestDate = query.value(3).toDateTime();
-      newItem.status = CreateCompanyRequestStatus(query.value(4).toInt());
-      newItem.statusChangeDate = query.value(5).toDateTime();
-      newItem.statusChangerId = UserID(query.value(6).toInt());
-    }
-    return list;
+  void VisitCreateCompanyRequests(
+    const AuthenticatedUser& admin,
+    const RowVisitor<CreateCompanyRequestData>& visitor
+  )
+  {
+    auto query = ExecuteLoadCreateCompanyRequests(admin);
+    StatementRegistry::VisitRows<CreateCompanyRequestData>(query, ReadCreateCompanyRequestData, visitor);
   }
 
+  const QString loadUserCreateCompanyRequestsStatement = StatementRegistry::Declare(
+    "SELECT "
+    " id, " // 0
+    " company_name, " // 1
+    " id_requester, " // 2
+    " request_date, " // 3
+    " request_status, " // 4
+    " status_change_date, " // 5
+    " id_status_changer " // 6
+    "FROM openings_create_company_request "
+    "WHERE id_requester=?");
+
   QList<CreateCompanyRequestData> LoadUserCreateCompanyRequests(
     const AuthenticatedUser& user
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  " id, " // 0
-                  " company_name, " // 1
-                  " id_requester, " // 2
-                  " request_date, " // 3
-                  " request_status, " // 4
-                  " status_change_date, " // 5
-                  " id_status_changer " // 6
-                  "FROM openings_create_company_request "
-                  "WHERE id_requester=?");
+    auto query = StatementRegistry::Prepare(loadUserCreateCompanyRequestsStatement);
     query.addBindValue(int(user.GetUserID()));
+    query.setForwardOnly(true);
     if (!query.exec()) {
       throw std::runtime_error("Error while loading create company request data list");
     }
 
-    QList<CreateCompanyRequestData> list;
-    while (query.next()) {
-      auto& newItem = list.emplace_back();
+    return StatementRegistry::ReadRows<CreateCompanyRequestData>(query, ReadCreateCompanyRequestData);
+  }
 
-      newItem.id = CreateCompanyRequestID(query.value(0).toInt());
-      newItem.companyName = query.value(1).toString();
-      newItem.requesterId = UserID(query.value(2).toInt());
-      newItem.requestDate = query.value(3).toDateTime();
-      newItem.status = CreateCompanyRequestStatus(query.value(4).toInt());
-      newItem.statusChangeDate = query.value(5).toDateTime();
-      newItem.statusChangerId = UserID(query.value(6).toInt());
-    }
-    return list;
+  EntityCacheStats GetCacheStats()
+  {
+    return CompanyCache().GetStats();
+  }
+
+  QFuture<std::optional<CompanyData>> LoadCompanyDataByIdAsync(
+    CompanyID id
+  )
+  {
+    return DatabasePool::Run([id] {
+      return DatabasePool::TakeOptional(LoadCompanyDataById(id));
+    });
+  }
+
+  QFuture<std::optional<CompanyData>> LoadCompanyDataByNameAsync(
+    QString companyName
+  )
+  {
+    return DatabasePool::Run([companyName] {
+      return DatabasePool::TakeOptional(LoadCompanyDataByName(companyName));
+    });
+  }
+
+  QFuture<QList<CompanyData>> LoadCompaniesAsync()
+  {
+    return DatabasePool::Run([] {
+      return LoadCompanies();
+    });
+  }
+
+  QFuture<QList<CompanyData>> LoadCompaniesAdministratedByAsync(
+    UserID userId
+  )
+  {
+    return DatabasePool::Run([userId] {
+      return LoadCompaniesAdministratedBy(userId);
+    });
+  }
+
+  QFuture<CompanySearchPage> SearchCompaniesAsync(
+    QString text,
+    std::optional<CompanySearchCursor> after,
+    int limit
+  )
+  {
+    return DatabasePool::Run([text, after, limit] {
+      return SearchCompanies(text, after, limit);
+    });
+  }
+
+  QFuture<QList<CreateCompanyRequestData>> LoadCreateCompanyRequestsAsync(
+    AuthenticatedUser admin
+  )
+  {
+    return DatabasePool::Run([admin] {
+      return LoadCreateCompanyRequests(admin);
+    });
+  }
+
+  QFuture<QList<CreateCompanyRequestData>> LoadUserCreateCompanyRequestsAsync(
+    AuthenticatedUser user
+  )
+  {
+    return DatabasePool::Run([user] {
+      return LoadUserCreateCompanyRequests(user);
+    });
+  }
+
+  QFuture<std::optional<CreateCompanyRequestData>> LoadCreateCompanyRequestDataAsync(
+    CreateCompanyRequestID id
+  )
+  {
+    return DatabasePool::Run([id] {
+      return DatabasePool::TakeOptional(LoadCreateCompanyRequestData(id));
+    });
   }
 }
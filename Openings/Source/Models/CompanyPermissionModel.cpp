@@ -1,37 +1,59 @@
 #include "CompanyPermissionModel.h"
 
-#include <QSqlQuery>
+#include "StatementRegistry.h"
 
 #include "CompanyModel.h"
 
 namespace CompanyPermissionModel {
 
   bool CanGrantOrRevokePermission(
-    UserID userId,
+    const AuthenticatedUser& admin,
     CompanyID companyId,
     PermissionID permission [[maybe_unused]]
   )
   {
-    auto company = CompanyModel::LoadCompanyDataById(companyId);
-    if (!company) {
-      throw std::runtime_error("No company with such id");
-    }
+    return admin.Permissions()->IsCompanyAdmin(companyId);
+  }
 
-    return company->companyAdmin == userId;
+  const QString isCompanyAdminStatement = StatementRegistry::Declare(
+    "SELECT id "
+    "FROM openings_company "
+    "WHERE id=:id_company "
+    "AND id_company_admin=:id_user");
+
+  namespace  {
+    // The snapshot may be older than the session's last login, so writes
+    // check the current state.
+    bool IsCompanyAdmin(
+      UserID userId,
+      CompanyID companyId
+    )
+    {
+      auto query = StatementRegistry::Prepare(isCompanyAdminStatement);
+      query.bindValue(":id_company", int(companyId));
+      query.bindValue(":id_user", int(userId));
+      if (!query.exec()) {
+        throw std::runtime_error("Error while checking company admin");
+      }
+
+      return query.next();
+    }
   }
 
+  const QString hasPermissionStatement = StatementRegistry::Declare(
+    "SELECT * "
+    "FROM openings_user_to_company_permission "
+    "WHERE id_user=:id_user "
+    "AND id_company=:id_company "
+    "AND id_permission=:id_permission");
+
   bool HasPermission(
     UserID userId,
     CompanyID companyId,
     PermissionID permission
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT * "
-                  "FROM openings_user_to_company_permission "
-                  "WHERE id_user=:id_user "
-                  "AND id_company=:id_company "
-                  "AND id_permission=:id_permission");
+    auto query = StatementRegistry::Prepare(hasPermissionStatement);
     query.bindValue(":id_user", int(userId));
     query.bindValue(":id_company", int(companyId));
     query.bindValue(":id_permission", int(permission));
@@ -42,6 +64,12 @@ namespace CompanyPermissionModel {
     return query.next();
   }
 
+  const QString grantPermissionStatement = StatementRegistry::Declare(
+    "INSERT INTO openings_user_to_company_permission "
+    "(id_user, id_permission, id_company) "
+    "VALUES (:id_user, :id_permission, :id_company) "
+    "ON CONFLICT (id_user, id_permission, id_company) DO NOTHING");
+
   void GrantPermission(
     const AuthenticatedUser& granter,
     UserID userId,
@@ -49,65 +77,66 @@ namespace CompanyPermissionModel {
     PermissionID permission
   )
   {
-    if (!CanGrantOrRevokePermission(granter.GetUserID(), companyId, permission)) {
+    if (!IsCompanyAdmin(granter.GetUserID(), companyId)) {
       throw std::runtime_error("No right to grant company permission");
     }
 
-    QSqlQuery query;
-    query.prepare("INSERT INTO openings_user_to_company_permission "
-                  "(id_user, id_permission, id_company) "
-                  "VALUES (:id_user, :id_permission, :id_company) "
-                  "ON CONFLICT (id_user, id_permission, id_company) DO NOTHING");
+    auto query = StatementRegistry::Prepare(grantPermissionStatement);
     query.bindValue(":id_user", int(userId));
     query.bindValue(":id_permission", int(permission));
     query.bindValue(":id_company", int(companyId));
     if (!query.exec()) {
       throw std::runtime_error("Error while granting company permission");
     }
+
+    if (userId == granter.GetUserID()) {
+      granter.RefreshPermissions();
+    }
   }
 
+  const QString loadCompaniesForWhichPermissionExistsStatement = StatementRegistry::Declare(
+    "SELECT "
+    " C.id, " // 0
+    " C.name, " // 1
+    " C.id_company_admin " // 2
+    "FROM openings_company C "
+    "JOIN openings_user_to_company_permission UCP "
+    "ON UCP.id_company=C.id "
+    "WHERE UCP.id_user=:id_user "
+    "AND UCP.id_permission=:id_permission ");
+
   QList<CompanyModel::CompanyData> LoadCompaniesForWhichPermissionExists(
     UserID user,
     PermissionID permissionId
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  " C.id, " // 0
-                  " C.name, " // 1
-                  " C.id_company_admin " // 2
-                  "FROM openings_company C "
-                  "JOIN openings_user_to_company_permission UCP "
-                  "ON UCP.id_company=C.id "
-                  "WHERE UCP.id_user=:id_user "
-                  "AND UCP.id_permission=:id_permission ");
+    auto query = StatementRegistry::Prepare(loadCompaniesForWhichPermissionExistsStatement);
     query.bindValue(":id_user", int(user));
     query.bindValue(":id_permission", int(permissionId));
+    query.setForwardOnly(true);
     if (!query.exec()) {
       throw std::runtime_error("Error while loading company data");
     }
 
-    QList<CompanyModel::CompanyData> dataList;
-    while (query.next()) {
-      auto& data = dataList.emplace_back();
-
+    return StatementRegistry::ReadRows<CompanyModel::CompanyData>(query, [] (auto& query, auto& data) {
       data.id = CompanyID(query.value(0).toInt());
       data.companyName = query.value(1).toString();
       data.companyAdmin = UserID(query.value(2).toInt());
-    }
-    return dataList;
+    });
   }
 
+  const QString loadCompanyPermissionsStatement = StatementRegistry::Declare(
+    "SELECT id_permission "
+    "FROM openings_user_to_company_permission "
+    "WHERE id_user=:id_user "
+    "AND id_company=:id_company ");
+
   std::vector<PermissionID> LoadCompanyPermissions(
     UserID userId,
     CompanyID companyId
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT id_permission "
-                  "FROM openings_user_to_company_permission "
-                  "WHERE id_user=:id_user "
-                  "AND id_company=:id_company ");
+    auto query = StatementRegistry::Prepare(loadCompanyPermissionsStatement);
     query.bindValue(":id_user", int(userId));
     query.bindValue(":id_company", int(companyId));
     if (!query.exec()) {
@@ -121,6 +150,13 @@ namespace CompanyPermissionModel {
     return permissions;
   }
 
+  const QString revokePermissionStatement = StatementRegistry::Declare(
+    "DELETE "
+    "FROM openings_user_to_company_permission "
+    "WHERE id_user=:id_user "
+    "AND id_company=:id_company "
+    "AND id_permission=:id_permission ");
+
   void RevokePermission(
     const AuthenticatedUser& revoker,
     UserID userId,
@@ -128,21 +164,20 @@ namespace CompanyPermissionModel {
     PermissionID permission
   )
   {
-    if (!CanGrantOrRevokePermission(revoker.GetUserID(), companyId, permission)) {
+    if (!IsCompanyAdmin(revoker.GetUserID(), companyId)) {
       throw std::runtime_error("No right to revoke company permission");
     }
 
-    QSqlQuery query;
-    query.prepare("DELETE "
-                  "FROM openings_user_to_company_permission "
-                  "WHERE id_user=:id_user "
-                  "AND id_company=:id_company "
-                  "AND id_permission=:id_permission ");
+    auto query = StatementRegistry::Prepare(revokePermissionStatement);
     query.bindValue(":id_user", int(userId));
     query.bindValue(":id_company", int(companyId));
     query.bindValue(":id_permission", int(permission));
     if (!query.exec()) {
       throw std::runtime_error("Error while revoking user permission");
     }
+
+    if (userId == revoker.GetUserID()) {
+      revoker.RefreshPermissions();
+    }
   }
 }
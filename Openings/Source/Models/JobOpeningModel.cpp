@@ -1,9 +1,132 @@
 #include "JobOpeningModel.h"
 
-#include <QSqlQuery>
+#include "StatementRegistry.h"
+#include "DatabasePool.h"
 #include <QSqlDatabase>
 
 #include "CompanyPermissionModel.h"
+#include "CopyIn.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace  {
+  auto& JobOpeningCache() {
+    static EntityCache<JobOpeningID, JobOpeningModel::JobOpeningData> cache(4096, std::chrono::minutes(1));
+    return cache;
+  }
+
+  void ReadJobOpeningData(
+    const StatementRegistry::Statement& query,
+    JobOpeningModel::JobOpeningData& data
+  )
+  {
+    data.id = JobOpeningID(query.value(0).toInt());
+    data.title = query.value(1).toString();
+    data.description = query.value(2).toString();
+    data.companyId = CompanyID(query.value(3).toInt());
+    data.createDate = query.value(4).toDateTime();
+    data.creatorId = UserID(query.value(5).toInt());
+    data.status = JobOpeningModel::JobOpeningStatus(query.value(6).toInt());
+    data.statusChangeDate = query.value(7).toDateTime();
+    data.statusChangerId = UserID(query.value(8).toInt());
+  }
+
+  // Optional parts of the opening list statements, combined into the
+  // index of the declared variant.
+  enum JobOpeningListPart {
+    ByStatus = 1,
+    ByCompany = 2,
+    ByCreator = 4,
+    AfterCursor = 8,
+    Limited = 16,
+  };
+
+  int FilterMask(
+    const std::optional<JobOpeningModel::JobOpeningStatus>& status,
+    const std::optional<CompanyID>& company,
+    const std::optional<UserID>& creator
+  )
+  {
+    return (status.has_value() ? ByStatus : 0) |
+           (company.has_value() ? ByCompany : 0) |
+           (creator.has_value() ? ByCreator : 0);
+  }
+
+  QString FilterSql(
+    int mask,
+    const QString& alias
+  )
+  {
+    QString sql;
+    if (mask & ByStatus) {
+      sql += "AND " + alias + ".opening_status=:opening_status ";
+    }
+    if (mask & ByCompany) {
+      sql += "AND " + alias + ".id_company=:id_company ";
+    }
+    if (mask & ByCreator) {
+      sql += "AND " + alias + ".id_creator=:id_creator ";
+    }
+    return sql;
+  }
+
+  void BindFilters(
+    StatementRegistry::Statement& query,
+    const std::optional<JobOpeningModel::JobOpeningStatus>& status,
+    const std::optional<CompanyID>& company,
+    const std::optional<UserID>& creator
+  )
+  {
+    if (status.has_value()) {
+      query.bindValue(":opening_status", int(status.value()));
+    }
+    if (company.has_value()) {
+      query.bindValue(":id_company", int(company.value()));
+    }
+    if (creator.has_value()) {
+      query.bindValue(":id_creator", int(creator.value()));
+    }
+  }
+
+  const QStringList loadJobOpeningsStatements = StatementRegistry::DeclareVariants(3, [] (int mask) {
+    return "SELECT "
+           "  id, " // 0
+           "  title, " // 1
+           "  description, " // 2
+           "  id_company, " // 3
+           "  create_date, " // 4
+           "  id_creator, " // 5
+           "  opening_status, " // 6
+           "  status_change_date, " // 7
+           "  id_status_changer " // 8
+           "FROM openings_job_opening AS O "
+           "WHERE TRUE " + FilterSql(mask, "O");
+  });
+
+  StatementRegistry::Statement ExecuteLoadJobOpenings(
+    std::optional<JobOpeningModel::JobOpeningStatus> status,
+    std::optional<CompanyID> company,
+    std::optional<UserID> creator
+  )
+  {
+    auto query = StatementRegistry::Prepare(loadJobOpeningsStatements[FilterMask(status, company, creator)]);
+    BindFilters(query, status, company, creator);
+    query.setForwardOnly(true);
+
+    if (!query.exec()) {
+      throw std::runtime_error("Error while loading job openings");
+    }
+    return query;
+  }
+}
 
 namespace JobOpeningModel {
   QList<JobOpeningData> LoadJobOpenings(
@@ -12,82 +135,227 @@ namespace JobOpeningModel {
     std::optional<UserID> creator
   )
   {
-    QString whereString;
-    {
-      bool isWhereAdded = false;
-      auto addWhereOrAnd = [&whereString, &isWhereAdded]() {
-        if (isWhereAdded) whereString += " AND";
-        else {whereString += " WHERE"; isWhereAdded = true;}
-      };
+    auto query = ExecuteLoadJobOpenings(status, company, creator);
+    return StatementRegistry::ReadRows<JobOpeningData>(query, ReadJobOpeningData);
+  }
 
-      if (status.has_value()) {
-        addWhereOrAnd();
-        whereString += " opening_status=" + QString::number(int(status.value()));
-      }
+  void VisitJobOpenings(
+    std::optional<JobOpeningStatus> status,
+    std::optional<CompanyID> company,
+    std::optional<UserID> creator,
+    const RowVisitor<JobOpeningData>& visitor
+  )
+  {
+    auto query = ExecuteLoadJobOpenings(status, company, creator);
+    StatementRegistry::VisitRows<JobOpeningData>(query, ReadJobOpeningData, visitor);
+  }
 
-      if (company.has_value()) {
-        addWhereOrAnd();
-        whereString += " id_company=" + QString::number(int(company.value()));
-      }
+  const QStringList loadJobOpeningListStatements = StatementRegistry::DeclareVariants(5, [] (int mask) {
+    QString sql("SELECT "
+                "  O.id, " // 0
+                "  O.title, " // 1
+                "  O.description, " // 2
+                "  O.id_company, " // 3
+                "  O.create_date, " // 4
+                "  O.id_creator, " // 5
+                "  O.opening_status, " // 6
+                "  O.status_change_date, " // 7
+                "  O.id_status_changer, " // 8
+                "  C.name, " // 9
+                "  CU.username, " // 10
+                "  SU.username, " // 11
+                "  CAST(EXTRACT(EPOCH FROM O.create_date) * 1000000 AS BIGINT) " // 12
+                "FROM openings_job_opening AS O "
+                "LEFT JOIN openings_company AS C ON C.id=O.id_company "
+                "LEFT JOIN openings_user AS CU ON CU.id=O.id_creator "
+                "LEFT JOIN openings_user AS SU ON SU.id=O.id_status_changer "
+                "WHERE TRUE ");
+    sql += FilterSql(mask, "O");
+    if (mask & AfterCursor) {
+      sql += "AND (O.create_date, O.id) > "
+             "(TIMESTAMP WITH TIME ZONE 'epoch' + :after_usec * INTERVAL '1 microsecond', :after_id) ";
+    }
+    if (mask & Limited) {
+      sql += "ORDER BY O.create_date, O.id "
+             "LIMIT :limit ";
+    }
+    return sql;
+  });
 
-      if (creator.has_value()) {
-        addWhereOrAnd();
-        whereString += " id_creator=" + QString::number(int(creator.value()));
-      }
+  JobOpeningListPage LoadJobOpeningList(
+    std::optional<JobOpeningStatus> status,
+    std::optional<CompanyID> company,
+    std::optional<UserID> creator,
+    std::optional<JobOpeningCursor> after,
+    std::optional<int> limit
+  )
+  {
+    auto mask = FilterMask(status, company, creator) |
+                (after.has_value() ? AfterCursor : 0) |
+                (limit.has_value() ? Limited : 0);
+    auto query = StatementRegistry::Prepare(loadJobOpeningListStatements[mask]);
+    BindFilters(query, status, company, creator);
+    if (after.has_value()) {
+      query.bindValue(":after_usec", after->createDateUsec);
+      query.bindValue(":after_id", int(after->id));
+    }
+    if (limit.has_value()) {
+      query.bindValue(":limit", limit.value());
+    }
+    query.setForwardOnly(true);
+
+    if (!query.exec()) {
+      throw std::runtime_error("Error while loading job opening list");
+    }
+
+    JobOpeningListPage page;
+    page.rows.reserve(limit.has_value() ? limit.value() : query.SizeHint());
+    while (query.next()) {
+      auto& data = page.rows.emplace_back();
+      ReadJobOpeningData(query, data);
+
+      data.companyName = query.value(9).toString();
+      data.creatorUsername = query.value(10).toString();
+      data.statusChangerUsername = query.value(11).toString();
+
+      page.next = JobOpeningCursor{query.value(12).toLongLong(), data.id};
     }
 
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  "  id, " // 0
-                  "  title, " // 1
-                  "  description, " // 2
-                  "  id_company, " // 3
-                  "  create_date, " // 4
-                  "  id_creator, " // 5
-                  "  opening_status, " // 6
-                  "  status_change_date, " // 7
-                  "  id_status_changer " // 8
-                  "FROM openings_job_opening" +
-                  whereString);
+    if (!limit.has_value() || page.rows.size() < limit.value()) {
+      page.next.reset();
+    }
+    return page;
+  }
+
+  QList<JobOpeningListData> LoadJobOpeningList(
+    std::optional<JobOpeningStatus> status,
+    std::optional<CompanyID> company,
+    std::optional<UserID> creator
+  )
+  {
+    return LoadJobOpeningList(status, company, creator, std::nullopt, std::nullopt).rows;
+  }
+
+  // The newest matches are taken first, by the GIN index on
+  // search_vector or by walking the create_date index backwards,
+  // whichever the planner expects to be cheaper. Only those are
+  // ranked, and the page is cut by keyset on (rank, id).
+  const QStringList searchJobOpeningsStatements = StatementRegistry::DeclareVariants(4, [] (int mask) {
+    QString sql("SELECT "
+                "  O.id, " // 0
+                "  O.title, " // 1
+                "  O.description, " // 2
+                "  O.id_company, " // 3
+                "  O.create_date, " // 4
+                "  O.id_creator, " // 5
+                "  O.opening_status, " // 6
+                "  O.status_change_date, " // 7
+                "  O.id_status_changer, " // 8
+                "  C.name, " // 9
+                "  CU.username, " // 10
+                "  SU.username, " // 11
+                "  CAST(EXTRACT(EPOCH FROM O.create_date) * 1000000 AS BIGINT), " // 12
+                "  O.rank " // 13
+                "FROM ( "
+                "  SELECT M.*, ts_rank(M.search_vector, M.query) AS rank "
+                "  FROM ( "
+                "    SELECT J.*, Q.query "
+                "    FROM openings_job_opening AS J, "
+                "         websearch_to_tsquery('english', :query) AS Q(query) "
+                "    WHERE J.search_vector @@ Q.query ");
+    sql += FilterSql(mask, "J");
+    sql += "    ORDER BY J.create_date DESC, J.id DESC "
+           "    LIMIT :candidates "
+           "  ) AS M "
+           ") AS O "
+           "LEFT JOIN openings_company AS C ON C.id=O.id_company "
+           "LEFT JOIN openings_user AS CU ON CU.id=O.id_creator "
+           "LEFT JOIN openings_user AS SU ON SU.id=O.id_status_changer ";
+    if (mask & AfterCursor) {
+      sql += "WHERE (O.rank, O.id) < (CAST(:after_rank AS REAL), :after_id) ";
+    }
+    sql += "ORDER BY O.rank DESC, O.id DESC "
+           "LIMIT :limit ";
+    return sql;
+  });
+
+  JobOpeningListPage SearchJobOpenings(
+    QString text,
+    const JobOpeningFilters& filters,
+    std::optional<JobOpeningCursor> after,
+    int limit
+  )
+  {
+    auto mask = FilterMask(filters.status, filters.company, filters.creator) |
+                (after.has_value() ? AfterCursor : 0);
+    auto query = StatementRegistry::Prepare(searchJobOpeningsStatements[mask]);
+    query.bindValue(":query", text);
+    query.bindValue(":candidates", searchCandidateLimit);
+    BindFilters(query, filters.status, filters.company, filters.creator);
+    if (after.has_value()) {
+      query.bindValue(":after_rank", double(after->rank));
+      query.bindValue(":after_id", int(after->id));
+    }
+    query.bindValue(":limit", limit);
+    query.setForwardOnly(true);
 
     if (!query.exec()) {
-      throw std::runtime_error("Error while loading job opening by id");
+      throw std::runtime_error("Error while searching job openings");
     }
 
-    QList<JobOpeningData> dataList;
+    JobOpeningListPage page;
+    page.rows.reserve(limit);
     while (query.next()) {
-      auto& data = dataList.emplace_back();
+      auto& data = page.rows.emplace_back();
+      ReadJobOpeningData(query, data);
+
+      data.companyName = query.value(9).toString();
+      data.creatorUsername = query.value(10).toString();
+      data.statusChangerUsername = query.value(11).toString();
 
-      data.id = JobOpeningID(query.value(0).toInt());
-      data.title = query.value(1).toString();
-      data.description = query.value(2).toString();
-      data.companyId = CompanyID(query.value(3).toInt());
-      data.createDate = query.value(4).toDateTime();
-      data.creatorId = UserID(query.value(5).toInt());
-      data.status = JobOpeningStatus(query.value(6).toInt());
-      data.statusChangeDate = query.value(7).toDateTime();
-      data.statusChangerId = UserID(query.value(8).toInt());
+      page.next = JobOpeningCursor{query.value(12).toLongLong(), data.id, float(query.value(13).toDouble())};
     }
-    return dataList;
+
+    if (page.rows.size() < limit) {
+      page.next.reset();
+    }
+    return page;
   }
 
+  JobOpeningListPage LoadJobOpeningListPage(
+    std::optional<JobOpeningStatus> status,
+    std::optional<CompanyID> company,
+    std::optional<UserID> creator,
+    std::optional<JobOpeningCursor> after,
+    int limit
+  )
+  {
+    return LoadJobOpeningList(status, company, creator, after, limit);
+  }
+
+  const QString loadJobOpeningByIdStatement = StatementRegistry::Declare(
+    "SELECT "
+    "  id, " // 0
+    "  title, " // 1
+    "  description, " // 2
+    "  id_company, " // 3
+    "  create_date, " // 4
+    "  id_creator, " // 5
+    "  opening_status, " // 6
+    "  status_change_date, " // 7
+    "  id_status_changer " // 8
+    "FROM openings_job_opening "
+    "WHERE id=?");
+
   std::unique_ptr<JobOpeningData> LoadJobOpeningById(
     JobOpeningID openingId
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  "  id, " // 0
-                  "  title, " // 1
-                  "  description, " // 2
-                  "  id_company, " // 3
-                  "  create_date, " // 4
-                  "  id_creator, " // 5
-                  "  opening_status, " // 6
-                  "  status_change_date, " // 7
-                  "  id_status_changer " // 8
-                  "FROM openings_job_opening "
-                  "WHERE id=?");
+    if (auto cached = JobOpeningCache().Find(openingId)) {
+      return std::make_unique<JobOpeningData>(std::move(cached.value()));
+    }
+
+    auto query = StatementRegistry::Prepare(loadJobOpeningByIdStatement);
     query.addBindValue(int(openingId));
 
     if (!query.exec()) {
@@ -107,31 +375,37 @@ namespace JobOpeningModel {
       ptr->status = JobOpeningStatus(query.value(6).toInt());
       ptr->statusChangeDate = query.value(7).toDateTime();
       ptr->statusChangerId = UserID(query.value(8).toInt());
+
+      JobOpeningCache().Insert(ptr->id, *ptr);
     }
     return ptr;
   }
 
+  // Guards writes, so it checks the database rather than the session
+  // snapshot, which may be older than a revocation.
   void EnsureCanWorkWithOpenings(
-    UserID userId,
+    const AuthenticatedUser& user,
     CompanyID companyId
   )
   {
-    if (!CompanyPermissionModel::HasPermission(userId, companyId, CompanyPermissionModel::PermissionID::WorkWithOpenings)) {
+    if (!CompanyPermissionModel::HasPermission(user.GetUserID(), companyId, CompanyPermissionModel::PermissionID::WorkWithOpenings)) {
       throw std::runtime_error("You have not gat the right to work with openings of this company");
     }
   }
 
+  const QString createJobOpeningStatement = StatementRegistry::Declare(
+    "INSERT INTO openings_job_opening "
+    "(title, description, id_company, id_creator, id_status_changer) "
+    "VALUES (:title, :description, :id_company, :id_requester, :id_requester)");
+
   void CreateJobOpening(
     const JobOpeningCreateData& data,
     const AuthenticatedUser& requester
   )
   {
-    EnsureCanWorkWithOpenings(requester.GetUserID(), data.companyId);
+    EnsureCanWorkWithOpenings(requester, data.companyId);
 
-    QSqlQuery query;
-    query.prepare("INSERT INTO openings_job_opening "
-                  "(title, description, id_company, id_creator, id_status_changer) "
-                  "VALUES (:title, :description, :id_company, :id_requester, :id_requester)");
+    auto query = StatementRegistry::Prepare(createJobOpeningStatement);
     query.bindValue(":title", data.title);
     query.bindValue(":description", data.description);
     query.bindValue(":id_company", int(data.companyId));
@@ -142,6 +416,13 @@ namespace JobOpeningModel {
     }
   }
 
+  const QString updateJobOpeningStatement = StatementRegistry::Declare(
+    "UPDATE openings_job_opening "
+    "SET "
+    "  title=:title, "
+    "  description=:description "
+    "WHERE id=:id");
+
   void UpdateJobOpening(
     const JobOpeningUpdateData& data,
     const AuthenticatedUser& requester
@@ -152,14 +433,9 @@ namespace JobOpeningModel {
       throw std::runtime_error("Opening with such id doesn't exist");
     }
 
-    EnsureCanWorkWithOpenings(requester.GetUserID(), opening->companyId);
+    EnsureCanWorkWithOpenings(requester, opening->companyId);
 
-    QSqlQuery query;
-    query.prepare("UPDATE openings_job_opening "
-                  "SET "
-                  "  title=:title, "
-                  "  description=:description "
-                  "WHERE id=:id");
+    auto query = StatementRegistry::Prepare(updateJobOpeningStatement);
     query.bindValue(":title", data.title);
     query.bindValue(":description", data.description);
     query.bindValue(":id", int(data.id));
@@ -167,33 +443,406 @@ namespace JobOpeningModel {
     if (!query.exec()) {
       throw std::runtime_error("Error while updating job opening status");
     }
-
+    JobOpeningCache().Invalidate(data.id);
   }
 
-  void CloseJobOpening(
-    JobOpeningID openingId,
+  // Closes the posted openings the requester may work with and reports
+  // the others, in one statement.
+  const QString closeJobOpeningsStatement = StatementRegistry::Declare(
+    "WITH target AS ( "
+    " SELECT "
+    "  O.id, "
+    "  O.opening_status, "
+    "  EXISTS (SELECT 1 "
+    "          FROM openings_user_to_company_permission AS P "
+    "          WHERE P.id_user=:id_status_changer "
+    "            AND P.id_company=O.id_company "
+    "            AND P.id_permission=:id_permission) AS can_manage "
+    " FROM openings_job_opening AS O "
+    " WHERE O.id=ANY(CAST(:ids AS integer[])) "
+    "), updated AS ( "
+    " UPDATE openings_job_opening AS O "
+    " SET "
+    "  opening_status=2, "
+    "  status_change_date=CURRENT_TIMESTAMP, "
+    "  id_status_changer=:id_status_changer "
+    " FROM target AS T "
+    " WHERE O.id=T.id "
+    "   AND T.can_manage "
+    "   AND O.opening_status=1 "
+    " RETURNING O.id "
+    ") "
+    "SELECT "
+    " T.id, " // 0
+    " T.can_manage, " // 1
+    " EXISTS (SELECT 1 FROM updated AS U WHERE U.id=T.id) " // 2
+    "FROM target AS T");
+
+  QList<BulkActionResult<JobOpeningID>> CloseJobOpenings(
+    const QList<JobOpeningID>& ids,
     const AuthenticatedUser& requester
   )
   {
-    auto opening = LoadJobOpeningById(openingId);
-    if (!opening) {
-      throw std::runtime_error("Opening with such id doesn't exist");
+    QList<BulkActionResult<JobOpeningID>> results;
+    if (ids.isEmpty()) {
+      return results;
     }
-    EnsureCanWorkWithOpenings(requester.GetUserID(), opening->companyId);
 
-    QSqlQuery query;
-    query.prepare("UPDATE openings_job_opening "
-                  "SET "
-                  "  opening_status=2, "
-                  "  status_change_date=CURRENT_TIMESTAMP, "
-                  "  id_status_changer=:id_status_changer "
-                  "WHERE "
-                  "  id=:id_opening");
+    auto query = StatementRegistry::Prepare(closeJobOpeningsStatement);
+    query.bindValue(":ids", StatementRegistry::IntArray(ids));
     query.bindValue(":id_status_changer", int(requester.GetUserID()));
-    query.bindValue(":id_opening", int(openingId));
+    query.bindValue(":id_permission", int(CompanyPermissionModel::PermissionID::WorkWithOpenings));
 
     if (!query.exec()) {
       throw std::runtime_error("Error while updating job opening status");
     }
+    for (auto id : ids) {
+      JobOpeningCache().Invalidate(id);
+    }
+
+    std::unordered_map<JobOpeningID, QString> errors;
+    errors.reserve(ids.size());
+    while (query.next()) {
+      auto& error = errors[JobOpeningID(query.value(0).toInt())];
+      if (query.value(2).toBool()) {
+        continue;
+      }
+      error = query.value(1).toBool() ? "Opening is already closed"
+                                      : "You have not gat the right to work with openings of this company";
+    }
+
+    results.reserve(ids.size());
+    for (auto id : ids) {
+      auto it = errors.find(id);
+      results.append({id, it != errors.end() ? it->second : "Opening with such id doesn't exist"});
+    }
+    return results;
+  }
+
+  void CloseJobOpening(
+    JobOpeningID openingId,
+    const AuthenticatedUser& requester
+  )
+  {
+    auto result = CloseJobOpenings({openingId}, requester).front();
+    if (!result.error.isEmpty()) {
+      throw std::runtime_error(result.error.toStdString());
+    }
+  }
+
+  namespace  {
+    struct ImportRecord {
+      qint64 record;
+      JobOpeningCreateData data;
+    };
+
+    // Splits RFC 4180 CSV: quoted fields may hold separators, quotes
+    // doubled and line breaks.
+    QList<QStringList> ParseCsv(
+      const QString& text
+    )
+    {
+      QList<QStringList> records;
+      QStringList fields;
+      QString field;
+      bool quoted = false;
+      bool fieldStarted = false;
+
+      auto endField = [&] {
+        fields.append(field);
+        field.clear();
+        fieldStarted = false;
+      };
+      auto endRecord = [&] {
+        endField();
+        if (fields.size() > 1 || !fields.front().isEmpty()) {
+          records.append(fields);
+        }
+        fields.clear();
+      };
+
+      for (qsizetype i = 0; i < text.size(); ++i) {
+        auto ch = text[i];
+        if (quoted) {
+          if (ch != '"') {
+            field += ch;
+          }
+          else if (i + 1 < text.size() && text[i + 1] == '"') {
+            field += ch;
+            ++i;
+          }
+          else {
+            quoted = false;
+          }
+          continue;
+        }
+
+        if (ch == '"' && !fieldStarted) {
+          quoted = true;
+          fieldStarted = true;
+        }
+        else if (ch == ',') {
+          endField();
+        }
+        else if (ch == '\n') {
+          endRecord();
+        }
+        else if (ch != '\r') {
+          field += ch;
+          fieldStarted = true;
+        }
+      }
+      if (fieldStarted || !fields.isEmpty()) {
+        endRecord();
+      }
+      return records;
+    }
+
+    void ReadCsvRecords(
+      const QByteArray& blob,
+      QList<ImportRecord>& records,
+      JobOpeningImportReport& report
+    )
+    {
+      auto rows = ParseCsv(QString::fromUtf8(blob));
+      if (rows.isEmpty()) {
+        return;
+      }
+
+      auto header = rows.front();
+      auto titleColumn = header.indexOf("title");
+      auto descriptionColumn = header.indexOf("description");
+      auto companyColumn = header.indexOf("company_id");
+      if (titleColumn < 0 || companyColumn < 0) {
+        throw std::runtime_error("CSV header has to name title and company_id columns");
+      }
+
+      records.reserve(rows.size() - 1);
+      for (qsizetype i = 1; i < rows.size(); ++i) {
+        auto& row = rows[i];
+        bool isInt = false;
+        auto companyId = row.value(companyColumn).trimmed().toInt(&isInt);
+        if (!isInt) {
+          report.rejected.append({i, "company_id is not a number"});
+          continue;
+        }
+        records.append(ImportRecord{i, {row.value(titleColumn), row.value(descriptionColumn), CompanyID(companyId)}});
+      }
+    }
+
+    void ReadJsonRecords(
+      const QByteArray& blob,
+      QList<ImportRecord>& records,
+      JobOpeningImportReport& report
+    )
+    {
+      auto document = QJsonDocument::fromJson(blob);
+      if (!document.isArray()) {
+        throw std::runtime_error("JSON import has to be an array of openings");
+      }
+
+      auto array = document.array();
+      records.reserve(array.size());
+      for (qsizetype i = 0; i < array.size(); ++i) {
+        auto object = array[i].toObject();
+        auto title = object["title"];
+        auto description = object["description"];
+        auto companyId = object["companyId"];
+        if (!title.isString() ||
+            !(description.isString() || description.isNull() || description.isUndefined()) ||
+            !companyId.isDouble()) {
+          report.rejected.append({i + 1, "Expected string title, optional string description and numeric companyId"});
+          continue;
+        }
+        records.append(ImportRecord{i + 1, {title.toString(), description.toString(), CompanyID(companyId.toInt())}});
+      }
+    }
+
+    const char* ValidateImportRecord(
+      const JobOpeningCreateData& data
+    )
+    {
+      if (data.title.trimmed().isEmpty()) {
+        return "Title is empty";
+      }
+      if (data.title.size() > JOB_OPENING_TITLE_SIZE) {
+        return "Title is too long";
+      }
+      if (data.description.size() > JOB_OPENING_DESCRIPTION_SIZE) {
+        return "Description is too long";
+      }
+      return nullptr;
+    }
+  }
+
+  // Companies among ids whose openings the user may work with.
+  const QString loadCompaniesWithOpeningsPermissionStatement = StatementRegistry::Declare(
+    "SELECT id_company "
+    "FROM openings_user_to_company_permission "
+    "WHERE id_user=:id_user "
+    "  AND id_permission=:id_permission "
+    "  AND id_company=ANY(CAST(:ids AS integer[]))");
+
+  JobOpeningImportReport ImportJobOpenings(
+    QIODevice& source,
+    ImportFormat format,
+    const AuthenticatedUser& requester
+  )
+  {
+    JobOpeningImportReport report;
+    QList<ImportRecord> records;
+
+    auto blob = source.readAll();
+    switch (format) {
+      case ImportFormat::Csv: ReadCsvRecords(blob, records, report); break;
+      case ImportFormat::Json: ReadJsonRecords(blob, records, report); break;
+    }
+
+    QList<CompanyID> companies;
+    std::unordered_set<CompanyID> seenCompanies;
+    for (auto& record : records) {
+      if (seenCompanies.insert(record.data.companyId).second) {
+        companies.append(record.data.companyId);
+      }
+    }
+
+    std::unordered_set<CompanyID> allowedCompanies;
+    if (!companies.isEmpty()) {
+      auto query = StatementRegistry::Prepare(loadCompaniesWithOpeningsPermissionStatement);
+      query.bindValue(":id_user", int(requester.GetUserID()));
+      query.bindValue(":id_permission", int(CompanyPermissionModel::PermissionID::WorkWithOpenings));
+      query.bindValue(":ids", StatementRegistry::IntArray(companies));
+      if (!query.exec()) {
+        throw std::runtime_error("Error while checking company permissions.\n" +
+                                 query.lastError().text().toStdString());
+      }
+      while (query.next()) {
+        allowedCompanies.insert(CompanyID(query.value(0).toInt()));
+      }
+    }
+
+    CopyIn copy(DatabasePool::Database(),
+                "COPY openings_job_opening "
+                "(title, description, id_company, id_creator, id_status_changer) "
+                "FROM STDIN");
+
+    auto requesterId = int(requester.GetUserID());
+    for (auto& record : records) {
+      if (auto reason = ValidateImportRecord(record.data)) {
+        report.rejected.append({record.record, reason});
+        continue;
+      }
+      if (!allowedCompanies.contains(record.data.companyId)) {
+        report.rejected.append({record.record, "You have not gat the right to work with openings of this company"});
+        continue;
+      }
+
+      copy.AddField(record.data.title);
+      if (record.data.description.isEmpty()) {
+        copy.AddNull();
+      }
+      else {
+        copy.AddField(record.data.description);
+      }
+      copy.AddField(int(record.data.companyId));
+      copy.AddField(requesterId);
+      copy.AddField(requesterId);
+      copy.EndRow();
+    }
+
+    report.imported = copy.Finish();
+
+    std::sort(report.rejected.begin(), report.rejected.end(), [] (auto& lhs, auto& rhs) {
+      return lhs.record < rhs.record;
+    });
+    return report;
+  }
+
+  EntityCacheStats GetCacheStats()
+  {
+    return JobOpeningCache().GetStats();
+  }
+
+  QFuture<QList<JobOpeningData>> LoadJobOpeningsAsync(
+    std::optional<JobOpeningStatus> status,
+    std::optional<CompanyID> company,
+    std::optional<UserID> creator
+  )
+  {
+    return DatabasePool::Run([status, company, creator] {
+      return LoadJobOpenings(status, company, creator);
+    });
+  }
+
+  QFuture<QList<JobOpeningListData>> LoadJobOpeningListAsync(
+    std::optional<JobOpeningStatus> status,
+    std::optional<CompanyID> company,
+    std::optional<UserID> creator
+  )
+  {
+    return DatabasePool::Run([status, company, creator] {
+      return LoadJobOpeningList(status, company, creator);
+    });
+  }
+
+  QFuture<JobOpeningListPage> LoadJobOpeningListPageAsync(
+    std::optional<JobOpeningStatus> status,
+    std::optional<CompanyID> company,
+    std::optional<UserID> creator,
+    std::optional<JobOpeningCursor> after,
+    int limit
+  )
+  {
+    return DatabasePool::Run([status, company, creator, after, limit] {
+      return LoadJobOpeningListPage(status, company, creator, after, limit);
+    });
+  }
+
+  QFuture<JobOpeningListPage> SearchJobOpeningsAsync(
+    QString query,
+    JobOpeningFilters filters,
+    std::optional<JobOpeningCursor> after,
+    int limit
+  )
+  {
+    return DatabasePool::Run([query, filters, after, limit] {
+      return SearchJobOpenings(query, filters, after, limit);
+    });
+  }
+
+  QFuture<std::optional<JobOpeningData>> LoadJobOpeningByIdAsync(
+    JobOpeningID id
+  )
+  {
+    return DatabasePool::Run([id] {
+      return DatabasePool::TakeOptional(LoadJobOpeningById(id));
+    });
+  }
+
+  QFuture<QList<BulkActionResult<JobOpeningID>>> CloseJobOpeningsAsync(
+    QList<JobOpeningID> ids,
+    AuthenticatedUser requester
+  )
+  {
+    return DatabasePool::Run([ids = std::move(ids), requester] {
+      return CloseJobOpenings(ids, requester);
+    });
+  }
+
+  QFuture<JobOpeningImportReport> ImportJobOpeningsAsync(
+    QString path,
+    AuthenticatedUser requester
+  )
+  {
+    return DatabasePool::Run([path, requester] {
+      QFile file(path);
+      if (!file.open(QIODevice::ReadOnly)) {
+        throw std::runtime_error("Cannot open import file");
+      }
+
+      auto format = QFileInfo(path).suffix().toLower() == "json" ? ImportFormat::Json
+                                                                 : ImportFormat::Csv;
+      return ImportJobOpenings(file, format, requester);
+    });
   }
 }
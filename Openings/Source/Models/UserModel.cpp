@@ -1,10 +1,24 @@
 #include "UserModel.h"
 
-#include <QSqlQuery>
+#include "UserPermissionModel.h"
+
+#include "StatementRegistry.h"
+#include "DatabasePool.h"
 
 #include <QCryptographicHash>
 
 namespace  {
+  void ReadUserData(
+    const StatementRegistry::Statement& query,
+    UserModel::UserData& data
+  )
+  {
+    data.id = UserID(query.value(0).toInt());
+    data.username = query.value(1).toString();
+    data.name = query.value(2).toString();
+    data.registrationDate = query.value(3).toDateTime();
+  }
+
   void EnsureUsernameSizeCorrect(
     QString username
   )
@@ -40,6 +54,11 @@ namespace  {
     }
   }
 
+  auto& UserCache() {
+    static EntityCache<UserID, UserModel::UserData> cache(4096, std::chrono::minutes(5));
+    return cache;
+  }
+
   auto GetDefaultHashAlg() {
     return QCryptographicHash::Sha256;
   };
@@ -57,6 +76,11 @@ namespace  {
 }
 
 namespace UserModel {
+  const QString insertUserStatement = StatementRegistry::Declare(
+    "INSERT INTO openings_user "
+    "(username, name, password_hash, hash_alg) "
+    "VALUES (:username, :name, :password_hash, :hash_alg)");
+
   std::unique_ptr<UserData> InsertUser(
     const InsertUserData& insertUserData,
     QString password
@@ -68,10 +92,7 @@ namespace UserModel {
     auto hashAlg = GetDefaultHashAlg();
     auto hash = ComputePasswordHash(password, hashAlg);
 
-    QSqlQuery query;
-    query.prepare("INSERT INTO openings_user "
-                  "(username, name, password_hash, hash_alg) "
-                  "VALUES (:username, :name, :password_hash, :hash_alg)");
+    auto query = StatementRegistry::Prepare(insertUserStatement);
     query.bindValue(":username", insertUserData.username);
     query.bindValue(":name", insertUserData.name);
     query.bindValue(":password_hash", hash);
@@ -84,43 +105,192 @@ namespace UserModel {
     return data;
   }
 
+  const QString loadUsersStatement = StatementRegistry::Declare(
+    "SELECT "
+    "id, " // 0
+    "username, " // 1
+    "name, " // 2
+    "registration_date " // 3
+    "FROM openings_user ");
+
+  namespace  {
+    StatementRegistry::Statement ExecuteLoadUsers()
+    {
+      auto query = StatementRegistry::Prepare(loadUsersStatement);
+      query.setForwardOnly(true);
+      if( !query.exec() ) {
+        throw std::runtime_error("Error while loading user data list");
+      }
+      return query;
+    }
+  }
+
   QList<UserData> LoadUsers()
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  "id, " // 0
-                  "username, " // 1
-                  "name, " // 2
-                  "registration_date " // 3
-                  "FROM openings_user ");
+    auto query = ExecuteLoadUsers();
+    return StatementRegistry::ReadRows<UserData>(query, ReadUserData);
+  }
+
+  void VisitUsers(
+    const RowVisitor<UserData>& visitor
+  )
+  {
+    auto query = ExecuteLoadUsers();
+    StatementRegistry::VisitRows<UserData>(query, ReadUserData, visitor);
+  }
+
+  const QString loadFirstUsersPageStatement = StatementRegistry::Declare(
+    "SELECT "
+    "id, " // 0
+    "username, " // 1
+    "name, " // 2
+    "registration_date, " // 3
+    "CAST(EXTRACT(EPOCH FROM registration_date) * 1000000 AS BIGINT) " // 4
+    "FROM openings_user "
+    "ORDER BY registration_date, id "
+    "LIMIT :limit ");
+
+  const QString loadUsersPageStatement = StatementRegistry::Declare(
+    "SELECT "
+    "id, " // 0
+    "username, " // 1
+    "name, " // 2
+    "registration_date, " // 3
+    "CAST(EXTRACT(EPOCH FROM registration_date) * 1000000 AS BIGINT) " // 4
+    "FROM openings_user "
+    "WHERE (registration_date, id) > "
+    "(TIMESTAMP WITH TIME ZONE 'epoch' + :after_usec * INTERVAL '1 microsecond', :after_id) "
+    "ORDER BY registration_date, id "
+    "LIMIT :limit ");
+
+  UserPage LoadUsersPage(
+    std::optional<UserCursor> after,
+    int limit
+  )
+  {
+    auto query = StatementRegistry::Prepare(after.has_value() ? loadUsersPageStatement
+                                                              : loadFirstUsersPageStatement);
+    if (after.has_value()) {
+      query.bindValue(":after_usec", after->registrationDateUsec);
+      query.bindValue(":after_id", int(after->id));
+    }
+    query.bindValue(":limit", limit);
+    query.setForwardOnly(true);
+
     if( !query.exec() ) {
       throw std::runtime_error("Error while loading user data list");
     }
 
-    QList<UserData> dataList;
+    UserPage page;
+    page.rows.reserve(limit);
+    while (query.next()) {
+      auto& data = page.rows.emplace_back();
+      ReadUserData(query, data);
+
+      page.next = UserCursor{query.value(4).toLongLong(), data.id};
+    }
+
+    if (page.rows.size() < limit) {
+      page.next.reset();
+    }
+    return page;
+  }
+
+  // The filter and the ordering both use the GiST trigram index on
+  // username and name, which returns the closest rows first, so the first
+  // page reads about a page of matches. The cursor of the later pages
+  // can't be an index condition on the distance: the index scan starts
+  // from the closest match again, so page N reads the N pages before it too.
+  const QString searchFirstUsersStatement = StatementRegistry::Declare(
+    "SELECT "
+    "id, " // 0
+    "username, " // 1
+    "name, " // 2
+    "registration_date, " // 3
+    "CAST(EXTRACT(EPOCH FROM registration_date) * 1000000 AS BIGINT), " // 4
+    "distance " // 5
+    "FROM ("
+    " SELECT *, (username || ' ' || name) <->> :text AS distance"
+    " FROM openings_user"
+    " WHERE (username || ' ' || name) %> :text"
+    ") AS matches "
+    "ORDER BY distance, id "
+    "LIMIT :limit ");
+
+  const QString searchUsersStatement = StatementRegistry::Declare(
+    "SELECT "
+    "id, " // 0
+    "username, " // 1
+    "name, " // 2
+    "registration_date, " // 3
+    "CAST(EXTRACT(EPOCH FROM registration_date) * 1000000 AS BIGINT), " // 4
+    "distance " // 5
+    "FROM ("
+    " SELECT *, (username || ' ' || name) <->> :text AS distance"
+    " FROM openings_user"
+    " WHERE (username || ' ' || name) %> :text"
+    ") AS matches "
+    "WHERE (distance, id) > (CAST(:after_distance AS REAL), :after_id) "
+    "ORDER BY distance, id "
+    "LIMIT :limit ");
+
+  UserPage SearchUsers(
+    QString text,
+    std::optional<UserCursor> after,
+    int limit
+  )
+  {
+    if (text.size() < TRIGRAM_SEARCH_MIN_SIZE) {
+      return UserPage();
+    }
+
+    auto query = StatementRegistry::Prepare(after.has_value() ? searchUsersStatement
+                                                              : searchFirstUsersStatement);
+    query.bindValue(":text", text);
+    if (after.has_value()) {
+      query.bindValue(":after_distance", double(after->distance));
+      query.bindValue(":after_id", int(after->id));
+    }
+    query.bindValue(":limit", limit);
+    query.setForwardOnly(true);
+
+    if( !query.exec() ) {
+      throw std::runtime_error("Error while searching users");
+    }
+
+    UserPage page;
+    page.rows.reserve(limit);
     while (query.next()) {
-      auto& data = dataList.emplace_back();
+      auto& data = page.rows.emplace_back();
+      ReadUserData(query, data);
+
+      page.next = UserCursor{query.value(4).toLongLong(), data.id, float(query.value(5).toDouble())};
+    }
 
-      data.id = UserID(query.value(0).toInt());
-      data.username = query.value(1).toString();
-      data.name = query.value(2).toString();
-      data.registrationDate = query.value(3).toDateTime();
+    if (page.rows.size() < limit) {
+      page.next.reset();
     }
-    return dataList;
+    return page;
   }
 
+  const QString loadByIdStatement = StatementRegistry::Declare(
+    "SELECT "
+    "id, " // 0
+    "username, " // 1
+    "name, " // 2
+    "registration_date " // 3
+    "FROM openings_user "
+    "WHERE id = ?");
+
   std::unique_ptr<UserData> LoadById(
     UserID id
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  "id, " // 0
-                  "username, " // 1
-                  "name, " // 2
-                  "registration_date " // 3
-                  "FROM openings_user "
-                  "WHERE id = ?");
+    if (auto cached = UserCache().Find(id)) {
+      return std::make_unique<UserData>(std::move(cached.value()));
+    }
+
+    auto query = StatementRegistry::Prepare(loadByIdStatement);
     query.addBindValue(int(id));
     if( !query.exec() ) {
       throw std::runtime_error("Error while loading user data by id");
@@ -135,25 +305,29 @@ namespace UserModel {
       data->username = query.value(1).toString();
       data->name = query.value(2).toString();
       data->registrationDate = query.value(3).toDateTime();
+
+      UserCache().Insert(data->id, *data);
     }
 
     return data;
   }
 
+  const QString loadByUsernameStatement = StatementRegistry::Declare(
+    "SELECT "
+    "id, " // 0
+    "username, " // 1
+    "name, " // 2
+    "registration_date " // 3
+    "FROM openings_user "
+    "WHERE username = :username");
+
   std::unique_ptr<UserData> LoadByUsername(
     QString username
   )
   {
     EnsureUsernameSizeCorrect(username);
 
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  "id, " // 0
-                  "username, " // 1
-                  "name, " // 2
-                  "registration_date " // 3
-                  "FROM openings_user "
-                  "WHERE username = :username");
+    auto query = StatementRegistry::Prepare(loadByUsernameStatement);
     query.bindValue(":username", username);
     if( !query.exec() ) {
       throw std::runtime_error("Error while loading user data by username");
@@ -168,11 +342,20 @@ namespace UserModel {
       data->username = query.value(1).toString();
       data->name = query.value(2).toString();
       data->registrationDate = query.value(3).toDateTime();
+
+      UserCache().Insert(data->id, *data);
     }
 
     return data;
   }
 
+  const QString updateUserDataStatement = StatementRegistry::Declare(
+    "UPDATE openings_user "
+    "SET "
+    "username = :username, "
+    "name = :name "
+    "WHERE id = :id");
+
   void UpdateUserData(
     const UserData& userData,
     QString password
@@ -188,12 +371,7 @@ namespace UserModel {
       throw std::runtime_error("Cannot change registration date");
     }
 
-    QSqlQuery query;
-    query.prepare("UPDATE openings_user "
-                  "SET "
-                  "username = :username, "
-                  "name = :name "
-                  "WHERE id = :id");
+    auto query = StatementRegistry::Prepare(updateUserDataStatement);
     query.bindValue(":username", userData.username);
     query.bindValue(":name", userData.name);
     query.bindValue(":id", int(userData.id));
@@ -201,19 +379,22 @@ namespace UserModel {
     if (!query.exec()) {
       throw std::runtime_error("Error while updating user data");
     }
+    UserCache().Invalidate(userData.id);
   }
 
+  const QString verifyPasswordStatement = StatementRegistry::Declare(
+    "SELECT "
+    "password_hash, "
+    "hash_alg "
+    "FROM openings_user "
+    "WHERE id = ?");
+
   bool VerifyPassword(
     UserID userId,
     QString password
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  "password_hash, "
-                  "hash_alg "
-                  "FROM openings_user "
-                  "WHERE id = ?");
+    auto query = StatementRegistry::Prepare(verifyPasswordStatement);
     query.addBindValue(int(userId));
 
     std::unique_ptr<UserData> data;
@@ -229,6 +410,78 @@ namespace UserModel {
     return hash == storedHash;
   }
 
+  // The user row comes with kind -1 and the credentials; the others are
+  // PermissionSnapshot rows, returned only when the password hash under
+  // the default algorithm matches.
+  const QString authenticateStatement = StatementRegistry::Declare(
+    "WITH L AS ( "
+    " SELECT id, password_hash, hash_alg "
+    " FROM openings_user "
+    " WHERE username=:username "
+    "), U AS ( "
+    " SELECT id "
+    " FROM L "
+    " WHERE hash_alg=:hash_alg AND password_hash=:password_hash "
+    ") "
+    "SELECT -1, L.id, 0, L.password_hash, L.hash_alg " // 0, 1, 2, 3, 4
+    "FROM L "
+    "UNION ALL "
+    "SELECT P.kind, P.permission, P.company, NULL, 0 "
+    "FROM (" + UserPermissionModel::PermissionRowsSql() + ") AS P(kind, permission, company) ");
+
+  LoginData Authenticate(
+    QString username,
+    QString password
+  )
+  {
+    auto defaultHashAlg = GetDefaultHashAlg();
+
+    auto query = StatementRegistry::Prepare(authenticateStatement);
+    query.bindValue(":username", username);
+    query.bindValue(":hash_alg", int(defaultHashAlg));
+    query.bindValue(":password_hash", ComputePasswordHash(password, defaultHashAlg));
+    if (!query.exec()) {
+      throw std::runtime_error("Error while logging in");
+    }
+
+    LoginData data;
+    std::optional<bool> passwordMatches;
+    auto hashAlg = defaultHashAlg;
+    while (query.next()) {
+      auto kind = query.value(0).toInt();
+      if (kind >= 0) {
+        data.permissions.AddRow(kind, query.value(1).toInt(), CompanyID(query.value(2).toInt()));
+        continue;
+      }
+
+      data.id = UserID(query.value(1).toInt());
+      auto storedHash = query.value(3).toByteArray();
+      hashAlg = QCryptographicHash::Algorithm(query.value(4).toInt());
+      passwordMatches = ComputePasswordHash(password, hashAlg) == storedHash;
+    }
+
+    if (!passwordMatches) {
+      throw std::runtime_error( "No user with username '" +
+                                username.toStdString() + "'" );
+    }
+    if (!*passwordMatches) {
+      throw std::runtime_error( "Incorrect password" );
+    }
+
+    // hashed under an older algorithm, so the statement held them back
+    if (hashAlg != defaultHashAlg) {
+      data.permissions = UserPermissionModel::LoadPermissionSnapshot(data.id);
+    }
+    return data;
+  }
+
+  const QString updatePasswordStatement = StatementRegistry::Declare(
+    "UPDATE openings_user "
+    "SET "
+    "password_hash = :hash, "
+    "hash_alg = :hash_alg "
+    "WHERE id = :id");
+
   void UpdatePassword(
     UserID userId,
     QString oldPassword,
@@ -240,12 +493,7 @@ namespace UserModel {
     auto hashAlg = GetDefaultHashAlg();
     auto hash = ComputePasswordHash(newPassword, hashAlg);
 
-    QSqlQuery query;
-    query.prepare("UPDATE openings_user "
-                  "SET "
-                  "password_hash = :hash, "
-                  "hash_alg = :hash_alg "
-                  "WHERE id = :id");
+    auto query = StatementRegistry::Prepare(updatePasswordStatement);
     query.bindValue(":hash", hash);
     query.bindValue(":hash_alg", hashAlg);
     query.bindValue(":id", int(userId));
@@ -255,6 +503,11 @@ namespace UserModel {
     }
   }
 
+  const QString deleteUserStatement = StatementRegistry::Declare(
+    "DELETE "
+    "FROM openings_user "
+    "WHERE id = ?");
+
   void DeleteUser(
     UserID userId,
     QString password
@@ -262,15 +515,62 @@ namespace UserModel {
   {
     EnsureCorrectPassword(userId, password);
 
-    QSqlQuery query;
-    query.prepare("DELETE "
-                  "FROM openings_user "
-                  "WHERE id = ?");
+    auto query = StatementRegistry::Prepare(deleteUserStatement);
     query.addBindValue(int(userId));
     if (!query.exec()) {
       throw std::runtime_error("Error while deleting a user");
     }
+    UserCache().Invalidate(userId);
   }
-}
 
+  EntityCacheStats GetCacheStats()
+  {
+    return UserCache().GetStats();
+  }
+
+  QFuture<std::optional<UserData>> LoadByIdAsync(
+    UserID id
+  )
+  {
+    return DatabasePool::Run([id] {
+      return DatabasePool::TakeOptional(LoadById(id));
+    });
+  }
+
+  QFuture<std::optional<UserData>> LoadByUsernameAsync(
+    QString username
+  )
+  {
+    return DatabasePool::Run([username] {
+      return DatabasePool::TakeOptional(LoadByUsername(username));
+    });
+  }
 
+  QFuture<QList<UserData>> LoadUsersAsync()
+  {
+    return DatabasePool::Run([] {
+      return LoadUsers();
+    });
+  }
+
+  QFuture<UserPage> LoadUsersPageAsync(
+    std::optional<UserCursor> after,
+    int limit
+  )
+  {
+    return DatabasePool::Run([after, limit] {
+      return LoadUsersPage(after, limit);
+    });
+  }
+
+  QFuture<UserPage> SearchUsersAsync(
+    QString text,
+    std::optional<UserCursor> after,
+    int limit
+  )
+  {
+    return DatabasePool::Run([text, after, limit] {
+      return SearchUsers(text, after, limit);
+    });
+  }
+}
@@ -1,28 +1,30 @@
 #include "UserPermissionModel.h"
 
-#include <QSqlQuery>
+#include "StatementRegistry.h"
 
 #include "AdminModel.h"
 
 namespace UserPermissionModel {
   bool CanGrantOrRevokePermission(
-    UserID userId,
+    const AuthenticatedUser& admin,
     PermissionID permission [[maybe_unused]]
   )
   {
-    return AdminModel::HasAdminRight(userId);
+    return admin.Permissions()->IsAdmin();
   }
 
+  const QString hasPermissionStatement = StatementRegistry::Declare(
+    "SELECT * "
+    "FROM openings_user_to_user_permission "
+    "WHERE id_user=:id_user "
+    "AND id_permission=:id_permission");
+
   bool HasPermission(
     UserID userId,
     PermissionID permission
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT * "
-                  "FROM openings_user_to_user_permission "
-                  "WHERE id_user=:id_user "
-                  "AND id_permission=:id_permission");
+    auto query = StatementRegistry::Prepare(hasPermissionStatement);
     query.bindValue(":id_user", int(userId));
     query.bindValue(":id_permission", int(permission));
     if (!query.exec()) {
@@ -32,47 +34,98 @@ namespace UserPermissionModel {
     return query.next();
   }
 
+  const QString grantPermissionStatement = StatementRegistry::Declare(
+    "INSERT INTO openings_user_to_user_permission "
+    "(id_user, id_permission) "
+    "VALUES (:id_user, :id_permission) "
+    "ON CONFLICT (id_user, id_permission) DO NOTHING");
+
   void GrantPermission(
     const AuthenticatedUser& granter,
     UserID userId,
     PermissionID permission
   )
   {
-    if (!CanGrantOrRevokePermission(granter.GetUserID(), permission)) {
+    // the snapshot may be outdated, writes check the current state
+    if (!AdminModel::HasAdminRight(granter.GetUserID())) {
       throw std::runtime_error("No right to grant user permission");
     }
 
-    QSqlQuery query;
-    query.prepare("INSERT INTO openings_user_to_user_permission "
-                  "(id_user, id_permission) "
-                  "VALUES (:id_user, :id_permission) "
-                  "ON CONFLICT (id_user, id_permission) DO NOTHING");
+    auto query = StatementRegistry::Prepare(grantPermissionStatement);
     query.bindValue(":id_user", int(userId));
     query.bindValue(":id_permission", int(permission));
     if (!query.exec()) {
       throw std::runtime_error("Error while granting user permission");
     }
+
+    if (userId == granter.GetUserID()) {
+      granter.RefreshPermissions();
+    }
   }
 
+  const QString revokePermissionStatement = StatementRegistry::Declare(
+    "DELETE "
+    "FROM openings_user_to_user_permission "
+    "WHERE id_user=:id_user "
+    "AND id_permission=:id_permission ");
+
   void RevokePermission(
     const AuthenticatedUser& revoker,
     UserID userId,
     PermissionID permission
   )
   {
-    if (!CanGrantOrRevokePermission(revoker.GetUserID(), permission)) {
+    if (!AdminModel::HasAdminRight(revoker.GetUserID())) {
       throw std::runtime_error("No right to revoke user permission");
     }
 
-    QSqlQuery query;
-    query.prepare("DELETE "
-                  "FROM openings_user_to_user_permission "
-                  "WHERE id_user=:id_user "
-                  "AND id_permission=:id_permission ");
+    auto query = StatementRegistry::Prepare(revokePermissionStatement);
     query.bindValue(":id_user", int(userId));
     query.bindValue(":id_permission", int(permission));
     if (!query.exec()) {
       throw std::runtime_error("Error while revoking user permission");
     }
+
+    if (userId == revoker.GetUserID()) {
+      revoker.RefreshPermissions();
+    }
+  }
+
+  QString PermissionRowsSql()
+  {
+    return
+      "SELECT 0, 0, 0 " // admin right
+      "FROM openings_admin AS A JOIN U ON A.id_user=U.id "
+      "UNION ALL "
+      "SELECT 1, P.id_permission, 0 " // user permission
+      "FROM openings_user_to_user_permission AS P JOIN U ON P.id_user=U.id "
+      "UNION ALL "
+      "SELECT 2, P.id_permission, P.id_company " // company permission
+      "FROM openings_user_to_company_permission AS P JOIN U ON P.id_user=U.id "
+      "UNION ALL "
+      "SELECT 3, 0, C.id " // administrated company
+      "FROM openings_company AS C JOIN U ON C.id_company_admin=U.id ";
+  }
+
+  const QString loadPermissionSnapshotStatement = StatementRegistry::Declare(
+    "WITH U AS (SELECT CAST(:id_user AS INTEGER) AS id) " + PermissionRowsSql());
+
+  PermissionSnapshot LoadPermissionSnapshot(
+    UserID userId
+  )
+  {
+    auto query = StatementRegistry::Prepare(loadPermissionSnapshotStatement);
+    query.bindValue(":id_user", int(userId));
+    if (!query.exec()) {
+      throw std::runtime_error("Error while loading user permissions");
+    }
+
+    PermissionSnapshot snapshot;
+    while (query.next()) {
+      snapshot.AddRow(query.value(0).toInt(),
+                      query.value(1).toInt(),
+                      CompanyID(query.value(2).toInt()));
+    }
+    return snapshot;
   }
 }
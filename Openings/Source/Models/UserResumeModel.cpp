@@ -1,55 +1,414 @@
 #include "UserResumeModel.h"
 
-#include <QSqlQuery>
+#include "StatementRegistry.h"
+#include "DatabasePool.h"
 #include <QSqlError>
+#include <QCryptographicHash>
+#include <QBuffer>
+#include <QFile>
+#include <QPromise>
+
+#include <utility>
+
+namespace  {
+  // Stored compressed only when that saves at least 1/8 of the size,
+  // already compressed formats are kept as they are.
+  std::pair<UserResumeModel::ResumeCodec, QByteArray> EncodeContent(
+    const QByteArray& blob
+  )
+  {
+    auto compressed = qCompress(blob, UserResumeModel::resumeCompressionLevel);
+    if (compressed.size() < blob.size() - blob.size() / 8) {
+      return {UserResumeModel::ResumeCodec::Zlib, compressed};
+    }
+    return {UserResumeModel::ResumeCodec::None, blob};
+  }
+
+  QByteArray DecodeContent(
+    UserResumeModel::ResumeCodec codec,
+    const QByteArray& stored
+  )
+  {
+    switch (codec) {
+      case UserResumeModel::ResumeCodec::None:
+        return stored;
+
+      case UserResumeModel::ResumeCodec::Zlib: {
+        auto blob = qUncompress(stored);
+        if (blob.isEmpty() && !stored.isEmpty()) {
+          throw std::runtime_error("Resume contents are corrupted");
+        }
+        return blob;
+      }
+    }
+    throw std::runtime_error("Unknown resume codec");
+  }
+
+  void ReportProgress(
+    const UserResumeModel::TransferProgress& progress,
+    qint64 done,
+    qint64 total
+  )
+  {
+    if (progress && !progress(done, total)) {
+      throw std::runtime_error("Resume transfer cancelled");
+    }
+  }
+
+
+  // QFuture progress is an int, so transfers report per cent.
+  template <class T>
+  UserResumeModel::TransferProgress PromiseProgress(
+    QPromise<T>& promise
+  )
+  {
+    promise.setProgressRange(0, 100);
+    return [&promise] (qint64 done, qint64 total) {
+      promise.setProgressValue(total > 0 ? int(done * 100 / total) : 100);
+      return !promise.isCanceled();
+    };
+  }
+}
 
 namespace UserResumeModel {
+  QByteArray ContentHash(
+    const QByteArray& blob
+  )
+  {
+    return QCryptographicHash::hash(blob, QCryptographicHash::Sha256);
+  }
+
+  QByteArray ContentHash(
+    QIODevice& source
+  )
+  {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&source)) {
+      throw std::runtime_error("Error while reading resume file");
+    }
+    return hash.result();
+  }
+
+  const QString findUserResumeStatement = StatementRegistry::Declare(
+    "SELECT id "
+    "FROM openings_user_resume "
+    "WHERE id_user=:id_user "
+    "AND content_hash=:content_hash "
+    "AND filename=:filename ");
+
+  const QString insertResumeContentStatement = StatementRegistry::Declare(
+    "INSERT INTO openings_resume_content "
+    "(content_hash, size, chunk_count) "
+    "VALUES (:content_hash, :size, :chunk_count) "
+    "ON CONFLICT (content_hash) DO NOTHING "
+    "RETURNING content_hash ");
+
+  const QString insertResumeChunkStatement = StatementRegistry::Declare(
+    "INSERT INTO openings_resume_chunk "
+    "(content_hash, chunk_no, codec, blob) "
+    "VALUES (:content_hash, :chunk_no, :codec, :blob) ");
+
+  const QString insertUserResumeStatement = StatementRegistry::Declare(
+    "INSERT INTO openings_user_resume "
+    "(filename, content_hash, id_user) "
+    "VALUES (:filename, :content_hash, :id_user) "
+    "ON CONFLICT (id_user, content_hash, filename) "
+    "DO UPDATE SET filename=EXCLUDED.filename "
+    "RETURNING id ");
+
   UserResumeID InsertUserResume(
     const InsertUserResumeData& data,
     AuthenticatedUser user
   )
   {
-    QSqlQuery query;
-    query.prepare("INSERT INTO openings_user_resume "
-                  "(filename, blob, id_user) "
-                  "VALUES (:filename, :blob, :id_user) ");
-    query.bindValue(":filename", data.filename);
-    query.bindValue(":blob", data.blob);
-    query.bindValue(":id_user", int(user.GetUserID()));
-    if (!query.exec()) {
-      throw std::runtime_error("Error while inserting user resume into the database" +
-                               query.lastError().text().toStdString());
+    QBuffer source;
+    source.setData(data.blob);
+    if (!source.open(QIODevice::ReadOnly)) {
+      throw std::runtime_error("Error while reading resume contents");
+    }
+    return UploadUserResume(data.filename, source, user);
+  }
+
+  UserResumeID UploadUserResume(
+    const QString& filename,
+    QIODevice& source,
+    AuthenticatedUser user,
+    const TransferProgress& progress
+  )
+  {
+    auto contentHash = ContentHash(source);
+    auto size = source.size();
+
+    {
+      auto query = StatementRegistry::Prepare(findUserResumeStatement);
+      query.bindValue(":id_user", int(user.GetUserID()));
+      query.bindValue(":content_hash", contentHash);
+      query.bindValue(":filename", filename);
+      if (!query.exec()) {
+        throw std::runtime_error("Error while looking for user resume.\n" +
+                                 query.lastError().text().toStdString());
+      }
+      if (query.next()) {
+        ReportProgress(progress, size, size);
+        return UserResumeID(query.value(0).toInt());
+      }
+    }
+
+    DatabasePool::Transaction transaction(DatabasePool::Database());
+
+    // Waits for a concurrent upload of the same contents to finish and
+    // returns no row if someone has stored them already.
+    bool hasContent = false;
+    {
+      auto query = StatementRegistry::Prepare(insertResumeContentStatement);
+      query.bindValue(":content_hash", contentHash);
+      query.bindValue(":size", size);
+      query.bindValue(":chunk_count", int((size + resumeChunkSize - 1) / resumeChunkSize));
+      if (!query.exec()) {
+        throw std::runtime_error("Error while inserting resume contents into the database" +
+                                 query.lastError().text().toStdString());
+      }
+      hasContent = !query.next();
+    }
+
+    if (!hasContent) {
+      if (!source.seek(0)) {
+        throw std::runtime_error("Error while reading resume file");
+      }
+
+      qint64 sent = 0;
+      for (int chunkNo = 0; sent < size; ++chunkNo) {
+        ReportProgress(progress, sent, size);
+
+        auto chunk = source.read(resumeChunkSize);
+        if (chunk.isEmpty()) {
+          throw std::runtime_error("Error while reading resume file");
+        }
+        sent += chunk.size();
+
+        auto [codec, stored] = EncodeContent(chunk);
+
+        auto query = StatementRegistry::Prepare(insertResumeChunkStatement);
+        query.bindValue(":content_hash", contentHash);
+        query.bindValue(":chunk_no", chunkNo);
+        query.bindValue(":codec", int(codec));
+        query.bindValue(":blob", stored);
+        if (!query.exec()) {
+          throw std::runtime_error("Error while inserting resume contents into the database" +
+                                   query.lastError().text().toStdString());
+        }
+      }
+    }
+
+    UserResumeID resumeId;
+    {
+      auto query = StatementRegistry::Prepare(insertUserResumeStatement);
+      query.bindValue(":filename", filename);
+      query.bindValue(":content_hash", contentHash);
+      query.bindValue(":id_user", int(user.GetUserID()));
+      if (!query.exec() || !query.next()) {
+        throw std::runtime_error("Error while inserting user resume into the database" +
+                                 query.lastError().text().toStdString());
+      }
+      resumeId = UserResumeID(query.value(0).toInt());
+    }
+
+    // A cancellation is honoured up to here, once committed the upload
+    // has happened and is reported as such.
+    ReportProgress(progress, size, size);
+    transaction.Commit();
+    return resumeId;
+  }
+
+  const QString loadUserResumeContentStatement = StatementRegistry::Declare(
+    "SELECT "
+    "  C.content_hash, " // 0
+    "  C.size, " // 1
+    "  C.chunk_count, " // 2
+    "  C.codec, " // 3
+    "  C.blob " // 4
+    "FROM openings_user_resume AS R "
+    "JOIN openings_resume_content AS C ON C.content_hash=R.content_hash "
+    "WHERE R.id=:id");
+
+  const QString loadResumeChunkStatement = StatementRegistry::Declare(
+    "SELECT "
+    "  codec, " // 0
+    "  blob " // 1
+    "FROM openings_resume_chunk "
+    "WHERE content_hash=:content_hash "
+    "AND chunk_no=:chunk_no ");
+
+  void DownloadUserResume(
+    UserResumeID id,
+    QIODevice& target,
+    const TransferProgress& progress
+  )
+  {
+    QByteArray contentHash;
+    qint64 size = 0;
+    int chunkCount = 0;
+    {
+      auto query = StatementRegistry::Prepare(loadUserResumeContentStatement);
+      query.bindValue(":id", int(id));
+      if (!query.exec()) {
+        throw std::runtime_error("Error while loading user resume");
+      }
+      if (!query.next()) {
+        throw std::runtime_error("Cannot load specified resume");
+      }
+
+      contentHash = query.value(0).toByteArray();
+      size = query.value(1).toLongLong();
+      chunkCount = query.value(2).toInt();
+
+      // stored inline before contents were chunked
+      if (chunkCount == 0) {
+        auto blob = DecodeContent(ResumeCodec(query.value(3).toInt()), query.value(4).toByteArray());
+        if (target.write(blob) != blob.size()) {
+          throw std::runtime_error("Error while writing resume file");
+        }
+        ReportProgress(progress, size, size);
+        return;
+      }
     }
 
-    return UserResumeID(query.lastInsertId().toInt());
+    qint64 received = 0;
+    for (int chunkNo = 0; chunkNo < chunkCount; ++chunkNo) {
+      ReportProgress(progress, received, size);
+
+      auto query = StatementRegistry::Prepare(loadResumeChunkStatement);
+      query.bindValue(":content_hash", contentHash);
+      query.bindValue(":chunk_no", chunkNo);
+      if (!query.exec() || !query.next()) {
+        throw std::runtime_error("Error while loading user resume");
+      }
+
+      auto chunk = DecodeContent(ResumeCodec(query.value(0).toInt()), query.value(1).toByteArray());
+      if (target.write(chunk) != chunk.size()) {
+        throw std::runtime_error("Error while writing resume file");
+      }
+      received += chunk.size();
+    }
+    ReportProgress(progress, size, size);
   }
 
   std::unique_ptr<UserResumeData> LoadUserResume(
     UserResumeID id
   )
   {
-    QSqlQuery query;
-    query.prepare("SELECT "
-                  "  id, " // 0
-                  "  filename, " // 1
-                  "  blob, " // 2
-                  "  id_user " // 3
-                  "FROM openings_user_resume "
-                  "WHERE id=:id");
+    auto info = LoadUserResumeInfo(id);
+    if (!info) {
+      return nullptr;
+    }
+
+    auto ptr = std::make_unique<UserResumeData>();
+    ptr->id = info->id;
+    ptr->userId = info->userId;
+    ptr->filename = info->filename;
+    ptr->blob = LoadUserResumeBlob(id);
+    return ptr;
+  }
+
+  const QString loadUserResumeInfoStatement = StatementRegistry::Declare(
+    "SELECT "
+    "  R.id, " // 0
+    "  R.filename, " // 1
+    "  C.size, " // 2
+    "  R.id_user, " // 3
+    "  R.content_hash " // 4
+    "FROM openings_user_resume AS R "
+    "JOIN openings_resume_content AS C ON C.content_hash=R.content_hash "
+    "WHERE R.id=:id");
+
+  std::unique_ptr<UserResumeInfo> LoadUserResumeInfo(
+    UserResumeID id
+  )
+  {
+    auto query = StatementRegistry::Prepare(loadUserResumeInfoStatement);
     query.bindValue(":id", int(id));
     if (!query.exec()) {
-      throw std::runtime_error("Error while inserting user resume into the database");
+      throw std::runtime_error("Error while loading user resume info");
     }
 
-    std::unique_ptr<UserResumeData> ptr;
+    std::unique_ptr<UserResumeInfo> ptr;
     if (query.next()) {
-      ptr = std::make_unique<UserResumeData>();
+      ptr = std::make_unique<UserResumeInfo>();
 
       ptr->id = UserResumeID(query.value(0).toInt());
       ptr->filename = query.value(1).toString();
-      ptr->blob = query.value(2).toByteArray();
+      ptr->size = query.value(2).toLongLong();
       ptr->userId = UserID(query.value(3).toInt());
+      ptr->contentHash = query.value(4).toByteArray();
     }
     return ptr;
   }
+
+  QByteArray LoadUserResumeBlob(
+    UserResumeID id
+  )
+  {
+    QBuffer target;
+    if (!target.open(QIODevice::WriteOnly)) {
+      throw std::runtime_error("Error while loading user resume");
+    }
+    DownloadUserResume(id, target);
+    return target.data();
+  }
+
+  QFuture<std::optional<UserResumeData>> LoadUserResumeAsync(
+    UserResumeID id
+  )
+  {
+    return DatabasePool::Run([id] {
+      return DatabasePool::TakeOptional(LoadUserResume(id));
+    });
+  }
+
+  QFuture<std::optional<UserResumeInfo>> LoadUserResumeInfoAsync(
+    UserResumeID id
+  )
+  {
+    return DatabasePool::Run([id] {
+      return DatabasePool::TakeOptional(LoadUserResumeInfo(id));
+    });
+  }
+
+  QFuture<QByteArray> LoadUserResumeBlobAsync(
+    UserResumeID id
+  )
+  {
+    return DatabasePool::Run([id] {
+      return LoadUserResumeBlob(id);
+    });
+  }
+
+  QFuture<UserResumeID> UploadUserResumeAsync(
+    QString filename,
+    QString path,
+    AuthenticatedUser user
+  )
+  {
+    return DatabasePool::RunWithPromise<UserResumeID>([filename, path, user] (QPromise<UserResumeID>& promise) {
+      QFile source(path);
+      if (!source.open(QIODevice::ReadOnly)) {
+        throw std::runtime_error("Error while opening resume file");
+      }
+      return UploadUserResume(filename, source, user, PromiseProgress(promise));
+    });
+  }
+
+  QFuture<void> DownloadUserResumeAsync(
+    UserResumeID id,
+    QString path
+  )
+  {
+    return DatabasePool::RunWithPromise<void>([id, path] (QPromise<void>& promise) {
+      QFile target(path);
+      if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw std::runtime_error("Error while opening resume file");
+      }
+      DownloadUserResume(id, target, PromiseProgress(promise));
+    });
+  }
 }
@@ -0,0 +1,70 @@
+#include "PermissionSnapshot.h"
+
+bool PermissionSnapshot::Test(
+  const Bits& bits,
+  int bit
+)
+{
+  return bit >= 0 && bit < int(bits.size()) && bits.test(bit);
+}
+
+void PermissionSnapshot::SetAdmin(
+  bool admin
+)
+{
+  this->admin = admin;
+}
+
+void PermissionSnapshot::AddUserPermission(
+  int permission
+)
+{
+  if (permission >= 0 && permission < int(userPermissions.size())) {
+    userPermissions.set(permission);
+  }
+}
+
+void PermissionSnapshot::AddCompanyPermission(
+  CompanyID companyId,
+  int permission
+)
+{
+  auto& bits = companyPermissions[companyId];
+  if (permission >= 0 && permission < int(bits.size())) {
+    bits.set(permission);
+  }
+}
+
+void PermissionSnapshot::AddAdministratedCompany(
+  CompanyID companyId
+)
+{
+  companyPermissions[companyId].set(companyAdminBit);
+}
+
+void PermissionSnapshot::AddRow(
+  int kind,
+  int permission,
+  CompanyID companyId
+)
+{
+  switch (kind) {
+    case 0: SetAdmin(true); break;
+    case 1: AddUserPermission(permission); break;
+    case 2: AddCompanyPermission(companyId, permission); break;
+    case 3: AddAdministratedCompany(companyId); break;
+  }
+}
+
+bool PermissionSnapshot::IsAdmin() const
+{
+  return admin;
+}
+
+bool PermissionSnapshot::IsCompanyAdmin(
+  CompanyID companyId
+) const
+{
+  auto it = companyPermissions.find(companyId);
+  return it != companyPermissions.end() && it->second.test(companyAdminBit);
+}
@@ -0,0 +1,155 @@
+#include "ResumeCache.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace  {
+  qint64 maxCacheBytes = 64 * 1024 * 1024;
+
+  // A download keeps writing its partial file, one untouched for this
+  // long was left behind by a crash.
+  constexpr qint64 stalePartialSecs = 24 * 3600;
+
+  QDir CacheDir()
+  {
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/resumes");
+    if (!dir.exists() && !dir.mkpath(".")) {
+      throw std::runtime_error("Error while creating resume cache directory");
+    }
+    return dir;
+  }
+
+  QString EntryName(
+    const QByteArray& contentHash
+  )
+  {
+    return QString::fromLatin1(contentHash.toHex());
+  }
+
+  // Each entry is a directory named by the hash holding one file, so the
+  // file keeps its name and extension for the application opening it.
+  QString EntryFilePath(
+    const QByteArray& contentHash,
+    const QString& filename
+  )
+  {
+    return CacheDir().filePath(EntryName(contentHash) + "/" + QFileInfo(filename).fileName());
+  }
+
+  struct CachedEntry {
+    QString name;
+    qint64 size;
+    QDateTime lastUsed;
+  };
+
+  void EvictAbove(
+    qint64 maxBytes,
+    const QString& keptEntry
+  )
+  {
+    auto dir = CacheDir();
+
+    std::vector<CachedEntry> entries;
+    qint64 totalSize = 0;
+    for (auto& name : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+      auto& entry = entries.emplace_back();
+      entry.name = name;
+      entry.size = 0;
+      for (auto& file : QDir(dir.filePath(name)).entryInfoList(QDir::Files)) {
+        entry.size += file.size();
+        entry.lastUsed = std::max(entry.lastUsed, file.lastModified());
+      }
+      totalSize += entry.size;
+    }
+
+    std::sort(entries.begin(), entries.end(), [] (auto& a, auto& b) {
+      return a.lastUsed < b.lastUsed;
+    });
+
+    for (auto& entry : entries) {
+      if (totalSize <= maxBytes) {
+        break;
+      }
+      if (entry.name == keptEntry) {
+        continue;
+      }
+      if (QDir(dir.filePath(entry.name)).removeRecursively()) {
+        totalSize -= entry.size;
+      }
+    }
+  }
+}
+
+namespace ResumeCache {
+  void Initialize(
+    qint64 maxBytes
+  )
+  {
+    maxCacheBytes = std::max<qint64>(maxBytes, 0);
+
+    // other instances may share the directory and be downloading
+    auto staleBefore = QDateTime::currentDateTime().addSecs(-stalePartialSecs);
+    for (auto& partial : CacheDir().entryInfoList({"*.part"}, QDir::Files)) {
+      if (partial.lastModified() < staleBefore) {
+        QFile::remove(partial.filePath());
+      }
+    }
+    EvictAbove(maxCacheBytes, {});
+  }
+
+  QString Find(
+    const QByteArray& contentHash,
+    const QString& filename
+  )
+  {
+    auto path = EntryFilePath(contentHash, filename);
+    QFile file(path);
+    if (!file.exists()) {
+      return {};
+    }
+
+    // modification time doubles as the last use time
+    if (file.open(QIODevice::ReadWrite)) {
+      file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+    return path;
+  }
+
+  QString PartialPath(
+    const QByteArray& contentHash
+  )
+  {
+    auto suffix = QString::number(QRandomGenerator::global()->generate64(), 16);
+    return CacheDir().filePath(EntryName(contentHash) + "." + suffix + ".part");
+  }
+
+  QString Insert(
+    const QByteArray& contentHash,
+    const QString& filename,
+    const QString& partialPath
+  )
+  {
+    auto path = EntryFilePath(contentHash, filename);
+    QDir().mkpath(QFileInfo(path).path());
+    // Rename doesn't replace an existing file. When another download of
+    // the same contents got there first, its file is the same one and
+    // may already be open.
+    if (!QFile::rename(partialPath, path)) {
+      QFile::remove(partialPath);
+      if (!QFile::exists(path)) {
+        throw std::runtime_error("Error while storing resume in the cache");
+      }
+    }
+
+    EvictAbove(maxCacheBytes, EntryName(contentHash));
+    return path;
+  }
+}
@@ -0,0 +1,375 @@
+#include "SchemaMigrations.h"
+
+#include "DatabasePool.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+
+#include <stdexcept>
+
+namespace  {
+  // Append only: a released migration is never edited, a new version
+  // is added instead.
+  const QList<SchemaMigrations::Migration> migrations {
+    // Versions 1 to 3 bring databases set up from the original script up
+    // to Example/db_setup.txt; on a database set up from it they change
+    // nothing.
+    {
+      1,
+      "Move resume contents into content-addressed storage",
+      false,
+      {
+        "CREATE TABLE IF NOT EXISTS openings_resume_content ( "
+        "  content_hash BYTEA PRIMARY KEY, "
+        "  size         BIGINT NOT NULL, "
+        "  chunk_count  INTEGER NOT NULL DEFAULT 0, "
+        "  codec        SMALLINT NOT NULL DEFAULT 0, "
+        "  blob         BYTEA "
+        ")",
+        "ALTER TABLE openings_resume_content ALTER COLUMN blob SET STORAGE EXTERNAL",
+        "CREATE TABLE IF NOT EXISTS openings_resume_chunk ( "
+        "  content_hash BYTEA NOT NULL, "
+        "  chunk_no     INTEGER NOT NULL, "
+        "  codec        SMALLINT NOT NULL DEFAULT 0, "
+        "  blob         BYTEA NOT NULL, "
+        "  PRIMARY KEY(content_hash, chunk_no), "
+        "  CONSTRAINT fk_content "
+        "    FOREIGN KEY(content_hash) "
+        "    REFERENCES openings_resume_content(content_hash) "
+        "    ON DELETE CASCADE "
+        ")",
+        "ALTER TABLE openings_resume_chunk ALTER COLUMN blob SET STORAGE EXTERNAL",
+        // Legacy rows hold the file in openings_user_resume.blob. It becomes
+        // one inline, uncompressed content row per SHA-256 hash, which is
+        // what UserResumeModel computes, and duplicate uploads of the same
+        // file under the same name collapse into the oldest row.
+        "DO $$ "
+        "BEGIN "
+        "  IF EXISTS (SELECT 1 "
+        "             FROM information_schema.columns "
+        "             WHERE table_schema=current_schema() "
+        "               AND table_name='openings_user_resume' "
+        "               AND column_name='blob') THEN "
+        "    INSERT INTO openings_resume_content (content_hash, size, chunk_count, codec, blob) "
+        "    SELECT DISTINCT ON (sha256(blob)) sha256(blob), length(blob), 0, 0, blob "
+        "    FROM openings_user_resume "
+        "    ON CONFLICT (content_hash) DO NOTHING; "
+        "    ALTER TABLE openings_user_resume ADD COLUMN content_hash BYTEA; "
+        "    UPDATE openings_user_resume SET content_hash=sha256(blob); "
+        "    ALTER TABLE openings_user_resume "
+        "      ALTER COLUMN content_hash SET NOT NULL, "
+        "      DROP COLUMN blob, "
+        "      ADD CONSTRAINT fk_content "
+        "        FOREIGN KEY(content_hash) "
+        "        REFERENCES openings_resume_content(content_hash); "
+        "    CREATE TEMPORARY TABLE openings_resume_duplicate ON COMMIT DROP AS "
+        "    SELECT id, keep "
+        "    FROM (SELECT id, MIN(id) OVER (PARTITION BY id_user, content_hash, filename) AS keep "
+        "          FROM openings_user_resume) AS R "
+        "    WHERE id<>keep; "
+        "    UPDATE openings_job_opening_application AS A "
+        "    SET id_resume=D.keep "
+        "    FROM openings_resume_duplicate AS D "
+        "    WHERE A.id_resume=D.id; "
+        "    DELETE FROM openings_user_resume AS R "
+        "    USING openings_resume_duplicate AS D "
+        "    WHERE R.id=D.id; "
+        "  END IF; "
+        "END "
+        "$$",
+        "CREATE UNIQUE INDEX IF NOT EXISTS openings_user_resume_content_idx "
+        "ON openings_user_resume (id_user, content_hash, filename)",
+        // The roles of the deployment aren't known here: whoever could
+        // write resumes before may write their contents now.
+        "DO $$ "
+        "DECLARE "
+        "  role_name TEXT; "
+        "BEGIN "
+        "  FOR role_name IN "
+        "    SELECT DISTINCT pg_get_userbyid(A.grantee) "
+        "    FROM pg_class AS C, aclexplode(C.relacl) AS A "
+        "    WHERE C.oid='openings_user_resume'::regclass "
+        "      AND A.privilege_type='INSERT' "
+        "      AND A.grantee NOT IN (0, C.relowner) "
+        "  LOOP "
+        "    EXECUTE format('GRANT SELECT, INSERT, UPDATE, DELETE "
+        "                    ON openings_resume_content, openings_resume_chunk "
+        "                    TO %I', role_name); "
+        "  END LOOP; "
+        "END "
+        "$$",
+      }
+    },
+    {
+      2,
+      "Add the full-text search vector of job openings",
+      false,
+      {
+        // rewrites the table
+        "ALTER TABLE openings_job_opening "
+        "ADD COLUMN IF NOT EXISTS search_vector TSVECTOR GENERATED ALWAYS AS ( "
+        "  setweight(to_tsvector('english', title), 'A') || "
+        "  setweight(to_tsvector('english', coalesce(description, '')), 'B') "
+        ") STORED",
+      }
+    },
+    {
+      3,
+      "Index keyset paging, full-text search and fuzzy search",
+      true,
+      {
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_user_registration_idx "
+        "ON openings_user (registration_date, id)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_job_opening_create_date_idx "
+        "ON openings_job_opening (create_date, id)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_job_opening_search_idx "
+        "ON openings_job_opening USING GIN (search_vector)",
+        // trusted since PostgreSQL 13, so the database owner may create it
+        "CREATE EXTENSION IF NOT EXISTS pg_trgm",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_user_username_trgm_idx "
+        "ON openings_user USING GIN (username gin_trgm_ops)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_user_name_trgm_idx "
+        "ON openings_user USING GIN (name gin_trgm_ops)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_company_name_trgm_idx "
+        "ON openings_company USING GIN (name gin_trgm_ops)",
+      }
+    },
+    {
+      4,
+      "Index foreign-key access paths of the list queries",
+      true,
+      {
+        // openings by company or creator, optionally by status
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_job_opening_company_idx "
+        "ON openings_job_opening (id_company, opening_status)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_job_opening_creator_idx "
+        "ON openings_job_opening (id_creator, opening_status)",
+        // applications of an opening, optionally by status
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_job_opening_application_opening_idx "
+        "ON openings_job_opening_application (id_opening, application_status)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_job_opening_application_resume_idx "
+        "ON openings_job_opening_application (id_resume)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_create_company_request_requester_idx "
+        "ON openings_create_company_request (id_requester, request_status)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_create_company_request_status_idx "
+        "ON openings_create_company_request (request_status)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_company_admin_idx "
+        "ON openings_company (id_company_admin)",
+        // the primary key leads with id_user
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_user_to_company_permission_company_idx "
+        "ON openings_user_to_company_permission (id_company)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_user_resume_content_hash_idx "
+        "ON openings_user_resume (content_hash)",
+      }
+    },
+    {
+      5,
+      "Index status changer references checked when a user is deleted",
+      true,
+      {
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_create_company_request_status_changer_idx "
+        "ON openings_create_company_request (id_status_changer)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_job_opening_status_changer_idx "
+        "ON openings_job_opening (id_status_changer)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_job_opening_application_status_changer_idx "
+        "ON openings_job_opening_application (id_status_changer)",
+      }
+    },
+    {
+      6,
+      "Make the registration date of users mandatory",
+      false,
+      {
+        // NULL dates sort after every other one and have no cursor value,
+        // so the keyset paging of users would skip or repeat them.
+        "UPDATE openings_user "
+        "SET registration_date=CURRENT_TIMESTAMP "
+        "WHERE registration_date IS NULL",
+        "ALTER TABLE openings_user "
+        "ALTER COLUMN registration_date SET NOT NULL",
+      }
+    },
+    {
+      7,
+      "Replace the GIN trigram indexes by GiST ones ordering by distance",
+      true,
+      {
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_user_search_trgm_idx "
+        "ON openings_user USING GIST ((username || ' ' || name) gist_trgm_ops)",
+        "CREATE INDEX CONCURRENTLY IF NOT EXISTS openings_company_search_trgm_idx "
+        "ON openings_company USING GIST (name gist_trgm_ops)",
+        // GIN can only filter, so every match was read and sorted
+        "DROP INDEX CONCURRENTLY IF EXISTS openings_user_username_trgm_idx",
+        "DROP INDEX CONCURRENTLY IF EXISTS openings_user_name_trgm_idx",
+        "DROP INDEX CONCURRENTLY IF EXISTS openings_company_name_trgm_idx",
+      }
+    },
+  };
+
+  void Execute(
+    QSqlQuery& query,
+    const QString& sql,
+    const std::string& what
+  )
+  {
+    if (!query.exec(sql)) {
+      throw std::runtime_error("Error while " + what + ".\n" +
+                               query.lastError().text().toStdString());
+    }
+  }
+
+  // Session level, so it also covers the statements of concurrent
+  // migrations, which run outside a transaction. Polled instead of
+  // waited for: a caller blocked in pg_advisory_lock keeps its snapshot
+  // open, CREATE INDEX CONCURRENTLY of the holder waits for that
+  // snapshot, and the deadlock detector aborts one of them.
+  class MigrationLock final
+  {
+    static constexpr unsigned long pollIntervalMs = 1000;
+
+    QSqlDatabase db;
+
+  public:
+    explicit MigrationLock(QSqlDatabase db)
+      : db(db)
+    {
+      QSqlQuery query(db);
+      while (true) {
+        Execute(query,
+                "SELECT pg_try_advisory_lock(hashtext('openings_schema_version'))",
+                "locking the schema version");
+        if (query.next() && query.value(0).toBool()) {
+          return;
+        }
+        query.finish();
+        QThread::msleep(pollIntervalMs);
+      }
+    }
+
+    MigrationLock(const MigrationLock&) = delete;
+    MigrationLock& operator=(const MigrationLock&) = delete;
+
+    ~MigrationLock()
+    {
+      QSqlQuery query(db);
+      query.exec("SELECT pg_advisory_unlock(hashtext('openings_schema_version'))");
+    }
+  };
+
+  // A failed CREATE INDEX CONCURRENTLY leaves an invalid index behind,
+  // which IF NOT EXISTS would then take for done.
+  void DropInvalidIndexes(
+    QSqlQuery& query
+  )
+  {
+    Execute(query,
+            "SELECT I.indexrelid::regclass::text "
+            "FROM pg_index AS I "
+            "JOIN pg_class AS C "
+            "ON C.oid=I.indexrelid "
+            "WHERE NOT I.indisvalid AND C.relname LIKE 'openings\\_%'",
+            "looking for invalid indexes");
+
+    QStringList names;
+    while (query.next()) {
+      names.append(query.value(0).toString());
+    }
+    for (auto& name : names) {
+      Execute(query,
+              "DROP INDEX CONCURRENTLY IF EXISTS " + name,
+              "dropping invalid index " + name.toStdString());
+    }
+  }
+
+  void RecordVersion(
+    QSqlQuery& query,
+    const SchemaMigrations::Migration& migration
+  )
+  {
+    query.prepare("INSERT INTO openings_schema_version (version, description) "
+                  "VALUES (:version, :description)");
+    query.bindValue(":version", migration.version);
+    query.bindValue(":description", migration.description);
+    if (!query.exec()) {
+      throw std::runtime_error("Error while recording schema migration " +
+                               std::to_string(migration.version) + ".\n" +
+                               query.lastError().text().toStdString());
+    }
+  }
+}
+
+namespace SchemaMigrations {
+  const QList<Migration>& Migrations()
+  {
+    return migrations;
+  }
+
+  int LatestVersion()
+  {
+    return migrations.isEmpty() ? 0 : migrations.back().version;
+  }
+
+  int CurrentVersion(
+    QSqlDatabase db
+  )
+  {
+    QSqlQuery query(db);
+    Execute(query,
+            "SELECT to_regclass('openings_schema_version') IS NOT NULL",
+            "checking the schema version table");
+    if (!query.next() || !query.value(0).toBool()) {
+      return 0;
+    }
+
+    Execute(query,
+            "SELECT COALESCE(MAX(version), 0) FROM openings_schema_version",
+            "loading the schema version");
+    return query.next() ? query.value(0).toInt() : 0;
+  }
+
+  QList<int> Migrate(
+    QSqlDatabase db
+  )
+  {
+    MigrationLock lock(db);
+
+    QSqlQuery query(db);
+    // databases set up before the table was part of db_setup.txt
+    Execute(query,
+            "CREATE TABLE IF NOT EXISTS openings_schema_version ( "
+            "  version     INTEGER PRIMARY KEY, "
+            "  description TEXT NOT NULL, "
+            "  applied_at  TIMESTAMP WITH TIME ZONE NOT NULL DEFAULT CURRENT_TIMESTAMP "
+            ")",
+            "creating the schema version table");
+
+    QList<int> applied;
+    for (auto& migration : migrations) {
+      if (migration.version <= CurrentVersion(db)) {
+        continue;
+      }
+
+      auto what = "applying schema migration " + std::to_string(migration.version);
+      if (migration.concurrent) {
+        // The statements are idempotent, so a migration interrupted
+        // halfway is simply run again.
+        DropInvalidIndexes(query);
+        for (auto& statement : migration.statements) {
+          Execute(query, statement, what);
+        }
+        RecordVersion(query, migration);
+      }
+      else {
+        DatabasePool::Transaction transaction(db);
+        for (auto& statement : migration.statements) {
+          Execute(query, statement, what);
+        }
+        RecordVersion(query, migration);
+        transaction.Commit();
+      }
+      applied.append(migration.version);
+    }
+    return applied;
+  }
+}
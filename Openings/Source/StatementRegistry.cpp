@@ -0,0 +1,264 @@
+#include "StatementRegistry.h"
+
+#include <QStringList>
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace StatementRegistry {
+  struct Entry {
+    QString connectionName;
+    QString sql;
+    std::unique_ptr<QSqlQuery> query;
+    bool inUse = false; // only touched by the thread owning the connection
+    std::atomic<qint64> prepareCount = 0;
+    std::atomic<qint64> executeCount = 0;
+    std::atomic<qint64> lastRowCount = 0;
+  };
+}
+
+namespace  {
+  using EntryMap = std::unordered_map<QString, std::unique_ptr<StatementRegistry::Entry>>;
+
+  auto& DeclaredStatements() {
+    static QStringList statements;
+    return statements;
+  }
+
+  auto& DeclaredVariants() {
+    static QStringList statements;
+    return statements;
+  }
+
+  auto& ConnectionEntries() {
+    static std::unordered_map<QString, EntryMap> entries;
+    return entries;
+  }
+
+  std::mutex entriesMutex;
+
+  std::unique_ptr<QSqlQuery> PrepareQuery(
+    StatementRegistry::Entry& entry,
+    QSqlDatabase db
+  )
+  {
+    auto query = std::make_unique<QSqlQuery>(db);
+    if (!query->prepare(entry.sql)) {
+      throw std::runtime_error("Error while preparing a statement.\n" +
+                               query->lastError().text().toStdString());
+    }
+    ++entry.prepareCount;
+    return query;
+  }
+
+  StatementRegistry::Entry& FindOrAddEntry(
+    const QString& sql,
+    QSqlDatabase db
+  )
+  {
+    std::lock_guard lock(entriesMutex);
+    auto& entries = ConnectionEntries()[db.connectionName()];
+    auto& entry = entries[sql];
+    if (!entry) {
+      entry = std::make_unique<StatementRegistry::Entry>();
+      entry->connectionName = db.connectionName();
+      entry->sql = sql;
+    }
+    return *entry;
+  }
+}
+
+namespace StatementRegistry {
+  Statement::Statement(
+    Entry* entry,
+    std::unique_ptr<QSqlQuery> ownQuery
+  )
+    : entry(entry)
+    , ownQuery(std::move(ownQuery))
+  {}
+
+  Statement::Statement(
+    Statement&& other
+  ) noexcept
+    : entry(other.entry)
+    , ownQuery(std::move(other.ownQuery))
+    , rowCount(other.rowCount)
+  {
+    other.entry = nullptr;
+  }
+
+  Statement::~Statement()
+  {
+    if (!entry) {
+      return;
+    }
+
+    if (rowCount > 0) {
+      entry->lastRowCount = rowCount;
+    }
+
+    if (ownQuery) {
+      ownQuery->finish();
+      return;
+    }
+
+    entry->query->finish();
+    entry->query->setForwardOnly(false);
+    entry->inUse = false;
+  }
+
+  QSqlQuery& Statement::Query() const
+  {
+    return ownQuery ? *ownQuery : *entry->query;
+  }
+
+  void Statement::setForwardOnly(
+    bool forward
+  )
+  {
+    Query().setForwardOnly(forward);
+  }
+
+  qint64 Statement::SizeHint() const
+  {
+    auto size = Query().size();
+    return size >= 0 ? size : entry->lastRowCount.load();
+  }
+
+  void Statement::bindValue(
+    const QString& placeholder,
+    const QVariant& value
+  )
+  {
+    Query().bindValue(placeholder, value);
+  }
+
+  void Statement::addBindValue(
+    const QVariant& value
+  )
+  {
+    Query().addBindValue(value);
+  }
+
+  bool Statement::exec()
+  {
+    ++entry->executeCount;
+    rowCount = 0;
+    return Query().exec();
+  }
+
+  bool Statement::next()
+  {
+    if (!Query().next()) {
+      return false;
+    }
+    ++rowCount;
+    return true;
+  }
+
+  QVariant Statement::value(
+    int index
+  ) const
+  {
+    return Query().value(index);
+  }
+
+  QSqlError Statement::lastError() const
+  {
+    return Query().lastError();
+  }
+
+  QVariant Statement::lastInsertId() const
+  {
+    return Query().lastInsertId();
+  }
+
+  int Statement::numRowsAffected() const
+  {
+    return Query().numRowsAffected();
+  }
+
+  QString Declare(
+    const QString& sql
+  )
+  {
+    DeclaredStatements().append(sql);
+    return sql;
+  }
+
+  QStringList DeclareVariants(
+    int optionalParts,
+    const std::function<QString(int mask)>& build
+  )
+  {
+    QStringList variants;
+    for (int mask = 0; mask < (1 << optionalParts); ++mask) {
+      variants.append(build(mask));
+    }
+    DeclaredVariants().append(variants);
+    return variants;
+  }
+
+  QStringList Declared()
+  {
+    return DeclaredStatements() + DeclaredVariants();
+  }
+
+  Statement Prepare(
+    const QString& sql,
+    QSqlDatabase db
+  )
+  {
+    auto& entry = FindOrAddEntry(sql, db);
+
+    if (entry.inUse) {
+      return Statement(&entry, PrepareQuery(entry, db));
+    }
+
+    if (!entry.query) {
+      entry.query = PrepareQuery(entry, db);
+    }
+    entry.inUse = true;
+    return Statement(&entry, nullptr);
+  }
+
+  void Warmup(
+    QSqlDatabase db
+  )
+  {
+    for (auto& sql : DeclaredStatements()) {
+      auto& entry = FindOrAddEntry(sql, db);
+      if (!entry.query) {
+        entry.query = PrepareQuery(entry, db);
+      }
+    }
+  }
+
+  void Forget(
+    const QString& connectionName
+  )
+  {
+    std::lock_guard lock(entriesMutex);
+    ConnectionEntries().erase(connectionName);
+  }
+
+  QList<StatementStats> LoadStats()
+  {
+    std::lock_guard lock(entriesMutex);
+    QList<StatementStats> statsList;
+    for (auto& [connectionName, entries] : ConnectionEntries()) {
+      for (auto& [sql, entry] : entries) {
+        auto& stats = statsList.emplace_back();
+
+        stats.connectionName = entry->connectionName;
+        stats.sql = entry->sql;
+        stats.prepareCount = entry->prepareCount;
+        stats.executeCount = entry->executeCount;
+        stats.lastRowCount = entry->lastRowCount;
+      }
+    }
+    return statsList;
+  }
+}
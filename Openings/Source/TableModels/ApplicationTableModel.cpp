@@ -0,0 +1,174 @@
+#include "ApplicationTableModel.h"
+
+#include <unordered_map>
+
+namespace  {
+  QString FormatActions(
+    ApplicationModel::ApplicationActions actions
+  )
+  {
+    QStringList names;
+    if (actions.testFlag(ApplicationModel::ApplicationAction::Accept)) {
+      names.append("Accept");
+    }
+    if (actions.testFlag(ApplicationModel::ApplicationAction::Deny)) {
+      names.append("Deny");
+    }
+    if (actions.testFlag(ApplicationModel::ApplicationAction::Cancel)) {
+      names.append("Cancel");
+    }
+    return names.join(", ");
+  }
+}
+
+ApplicationTableModel::ApplicationTableModel(
+  AuthenticatedUser user,
+  Mode mode,
+  QObject *parent
+)
+  : ListTableModel(parent)
+  , user(user)
+  , mode(mode)
+{}
+
+QFuture<QList<ApplicationModel::ApplicationListData>> ApplicationTableModel::LoadRows() const
+{
+  switch (mode) {
+    case Mode::createdBy:
+      return ApplicationModel::LoadApplicationListCreatedByAsync(user, std::nullopt);
+
+    case Mode::forOpeningsCreatedBy:
+      return ApplicationModel::LoadApplicationListForOpeningsCreatedByAsync(user, std::nullopt);
+  }
+  return {};
+}
+
+void ApplicationTableModel::ClearColumns()
+{
+  ids.clear();
+  openingIds.clear();
+  resumeIds.clear();
+  applicationDates.clear();
+  statuses.clear();
+  statusChangeDates.clear();
+  statusChangerIds.clear();
+  jobTitles.clear();
+  companyIds.clear();
+  companyNames.clear();
+  applicantIds.clear();
+  applicantUsernames.clear();
+  statusChangerUsernames.clear();
+  allowedActions.clear();
+}
+
+void ApplicationTableModel::AppendToColumns(
+  const QList<ApplicationModel::ApplicationListData>& rows
+)
+{
+  for (auto& row : rows) {
+    ids.append(row.id);
+    openingIds.append(row.openingId);
+    resumeIds.append(row.resumeId);
+    applicationDates.append(ToColumnDate(row.applicationDate));
+    statuses.append(quint8(row.status));
+    statusChangeDates.append(ToColumnDate(row.statusChangeDate));
+    statusChangerIds.append(row.statusChangerID);
+    jobTitles.append(row.jobTitle);
+    companyIds.append(row.companyId);
+    companyNames.append(row.companyName);
+    applicantIds.append(row.applicantId);
+    applicantUsernames.append(row.applicantUsername);
+    statusChangerUsernames.append(row.statusChangerUsername);
+    allowedActions.append(ApplicationModel::AllowedActions(row, user));
+  }
+}
+
+ApplicationModel::ApplicationListData ApplicationTableModel::RowAt(
+  int row
+) const
+{
+  ApplicationModel::ApplicationListData data;
+
+  data.id = ids[row];
+  data.openingId = openingIds[row];
+  data.resumeId = resumeIds[row];
+  data.applicationDate = QDateTime::fromMSecsSinceEpoch(applicationDates[row]);
+  data.status = ApplicationModel::ApplicationStatusID(statuses[row]);
+  data.statusChangeDate = QDateTime::fromMSecsSinceEpoch(statusChangeDates[row]);
+  data.statusChangerID = statusChangerIds[row];
+  data.jobTitle = jobTitles[row];
+  data.companyId = companyIds[row];
+  data.companyName = companyNames[row];
+  data.applicantId = applicantIds[row];
+  data.applicantUsername = applicantUsernames[row];
+  data.statusChangerUsername = statusChangerUsernames[row];
+  return data;
+}
+
+ApplicationModel::ApplicationActions ApplicationTableModel::ActionsAt(
+  int row
+) const
+{
+  return allowedActions[row];
+}
+
+int ApplicationTableModel::columnCount(
+  const QModelIndex &parent
+) const
+{
+  return parent.isValid() ? 0 : 8;
+}
+
+QVariant ApplicationTableModel::data(
+  const QModelIndex &index,
+  int role
+) const
+{
+  if (!index.isValid() || role != Qt::DisplayRole) {
+    return QVariant();
+  }
+
+  static std::unordered_map<ApplicationModel::ApplicationStatusID, QString> statusIdToString{
+    {ApplicationModel::ApplicationStatusID::Accepted, "Accepted"},
+    {ApplicationModel::ApplicationStatusID::Cancelled, "Cancelled"},
+    {ApplicationModel::ApplicationStatusID::Denied, "Denied"},
+    {ApplicationModel::ApplicationStatusID::Posted, "Posted"},
+  };
+
+  auto row = index.row();
+
+  switch (index.column()) {
+    case 0: return jobTitles[row];
+    case 1: return companyNames[row].isEmpty() ? "ERROR COMPANY" : companyNames[row];
+    case 2: return applicantUsernames[row].isEmpty() ? "ERROR USER" : applicantUsernames[row];
+    case 3: return FormatColumnDate(applicationDates[row]);
+    case 4: return statusIdToString[ApplicationModel::ApplicationStatusID(statuses[row])];
+    case 5: return FormatColumnDate(statusChangeDates[row]);
+    case 6: return statusChangerUsernames[row].isEmpty() ? "ERROR USER" : statusChangerUsernames[row];
+    case 7: return FormatActions(allowedActions[row]);
+  }
+  return QVariant();
+}
+
+QVariant ApplicationTableModel::headerData(
+  int section,
+  Qt::Orientation orientation,
+  int role
+) const
+{
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+    return QAbstractTableModel::headerData(section, orientation, role);
+  }
+
+  static const QStringList labels {
+    "Job Title",
+    "Company",
+    "Applicant",
+    "Application date",
+    "Status",
+    "Status change date",
+    "Status changer",
+    "Actions"
+  };
+  return labels.value(section);
+}
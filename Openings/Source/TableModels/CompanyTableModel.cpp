@@ -0,0 +1,128 @@
+#include "CompanyTableModel.h"
+
+#include "UserModel.h"
+
+#include <unordered_map>
+
+CompanyTableModel::CompanyTableModel(
+  QObject *parent
+)
+  : ListTableModel(parent)
+{}
+
+QFuture<QList<CompanyTableRow>> CompanyTableModel::LoadRows() const
+{
+  return DatabasePool::Run([searchText = searchText] {
+    std::unordered_map<int, QString> userIdToUsername;
+
+    // search results are capped at the best matches instead of paged
+    auto companies = searchText.isEmpty()
+        ? CompanyModel::LoadCompanies()
+        : CompanyModel::SearchCompanies(searchText, std::nullopt, 200).rows;
+
+    QList<CompanyTableRow> rows;
+    for (auto& company : companies) {
+      if (!userIdToUsername.count(company.companyAdmin)) {
+        if (auto userData = UserModel::LoadById(company.companyAdmin)) {
+          userIdToUsername.emplace(company.companyAdmin,
+                                   userData->username);
+        }
+        else userIdToUsername.emplace(company.companyAdmin, "ERROR USER");
+      }
+
+      auto& row = rows.emplace_back();
+      static_cast<CompanyModel::CompanyData&>(row) = company;
+      row.adminUsername = userIdToUsername[company.companyAdmin];
+    }
+    return rows;
+  });
+}
+
+bool CompanyTableModel::SetSearchText(
+  QString text
+)
+{
+  if (text.size() < TRIGRAM_SEARCH_MIN_SIZE) {
+    text.clear();
+  }
+  if (text == searchText) {
+    return false;
+  }
+  searchText = std::move(text);
+  return true;
+}
+
+void CompanyTableModel::ClearColumns()
+{
+  ids.clear();
+  companyNames.clear();
+  adminIds.clear();
+  adminUsernames.clear();
+}
+
+void CompanyTableModel::AppendToColumns(
+  const QList<CompanyTableRow>& rows
+)
+{
+  for (auto& row : rows) {
+    ids.append(row.id);
+    companyNames.append(row.companyName);
+    adminIds.append(row.companyAdmin);
+    adminUsernames.append(row.adminUsername);
+  }
+}
+
+CompanyTableRow CompanyTableModel::RowAt(
+  int row
+) const
+{
+  CompanyTableRow data;
+
+  data.id = ids[row];
+  data.companyName = companyNames[row];
+  data.companyAdmin = adminIds[row];
+  data.adminUsername = adminUsernames[row];
+  return data;
+}
+
+int CompanyTableModel::columnCount(
+  const QModelIndex &parent
+) const
+{
+  return parent.isValid() ? 0 : 2;
+}
+
+QVariant CompanyTableModel::data(
+  const QModelIndex &index,
+  int role
+) const
+{
+  if (!index.isValid() || role != Qt::DisplayRole) {
+    return QVariant();
+  }
+
+  auto row = index.row();
+
+  switch (index.column()) {
+    case 0: return companyNames[row];
+    case 1: return adminUsernames[row];
+  }
+  return QVariant();
+}
+
+QVariant CompanyTableModel::headerData(
+  int section,
+  Qt::Orientation orientation,
+  int role
+) const
+{
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+    return QAbstractTableModel::headerData(section, orientation, role);
+  }
+
+  static const QStringList labels {
+    "Company name",
+    "Admin"
+  };
+  return labels.value(section);
+}
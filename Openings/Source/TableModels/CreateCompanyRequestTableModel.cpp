@@ -0,0 +1,176 @@
+#include "CreateCompanyRequestTableModel.h"
+
+#include "UserModel.h"
+
+#include <unordered_map>
+
+namespace  {
+  enum Column {
+    companyNameColumn,
+    requesterColumn,
+    requestDateColumn,
+    statusColumn,
+    statusChangeDateColumn,
+    statusChangerColumn,
+  };
+
+  Column ToColumn(
+    int section,
+    CreateCompanyRequestTableModel::Mode mode
+  )
+  {
+    if (mode == CreateCompanyRequestTableModel::Mode::userRequests && section >= requesterColumn) {
+      ++section;
+    }
+    return Column(section);
+  }
+}
+
+CreateCompanyRequestTableModel::CreateCompanyRequestTableModel(
+  AuthenticatedUser user,
+  Mode mode,
+  QObject *parent
+)
+  : ListTableModel(parent)
+  , user(user)
+  , mode(mode)
+{}
+
+QFuture<QList<CreateCompanyRequestTableRow>> CreateCompanyRequestTableModel::LoadRows() const
+{
+  return DatabasePool::Run([user = user, mode = mode] {
+    auto requestList = mode == Mode::allRequests
+      ? CompanyModel::LoadCreateCompanyRequests(user)
+      : CompanyModel::LoadUserCreateCompanyRequests(user);
+
+    std::unordered_map<int, QString> userIdToUsername;
+    auto usernameOf = [&userIdToUsername] (UserID userId) {
+      if (!userIdToUsername.count(userId)) {
+        if (auto userData = UserModel::LoadById(userId)) {
+          userIdToUsername.emplace(userId, userData->username);
+        }
+        else userIdToUsername.emplace(userId, "ERROR USER");
+      }
+      return userIdToUsername[userId];
+    };
+
+    QList<CreateCompanyRequestTableRow> rows;
+    for (auto& req : requestList) {
+      auto& row = rows.emplace_back();
+      static_cast<CompanyModel::CreateCompanyRequestData&>(row) = req;
+      if (mode == Mode::allRequests) {
+        row.requesterUsername = usernameOf(req.requesterId);
+      }
+      row.statusChangerUsername = usernameOf(req.statusChangerId);
+    }
+    return rows;
+  });
+}
+
+void CreateCompanyRequestTableModel::ClearColumns()
+{
+  ids.clear();
+  companyNames.clear();
+  requesterIds.clear();
+  requesterUsernames.clear();
+  requestDates.clear();
+  statuses.clear();
+  statusChangeDates.clear();
+  statusChangerIds.clear();
+  statusChangerUsernames.clear();
+}
+
+void CreateCompanyRequestTableModel::AppendToColumns(
+  const QList<CreateCompanyRequestTableRow>& rows
+)
+{
+  for (auto& row : rows) {
+    ids.append(row.id);
+    companyNames.append(row.companyName);
+    requesterIds.append(row.requesterId);
+    requesterUsernames.append(row.requesterUsername);
+    requestDates.append(ToColumnDate(row.requestDate));
+    statuses.append(quint8(row.status));
+    statusChangeDates.append(ToColumnDate(row.statusChangeDate));
+    statusChangerIds.append(row.statusChangerId);
+    statusChangerUsernames.append(row.statusChangerUsername);
+  }
+}
+
+CreateCompanyRequestTableRow CreateCompanyRequestTableModel::RowAt(
+  int row
+) const
+{
+  CreateCompanyRequestTableRow data;
+
+  data.id = ids[row];
+  data.companyName = companyNames[row];
+  data.requesterId = requesterIds[row];
+  data.requesterUsername = requesterUsernames[row];
+  data.requestDate = QDateTime::fromMSecsSinceEpoch(requestDates[row]);
+  data.status = CreateCompanyRequestStatus(statuses[row]);
+  data.statusChangeDate = QDateTime::fromMSecsSinceEpoch(statusChangeDates[row]);
+  data.statusChangerId = statusChangerIds[row];
+  data.statusChangerUsername = statusChangerUsernames[row];
+  return data;
+}
+
+int CreateCompanyRequestTableModel::columnCount(
+  const QModelIndex &parent
+) const
+{
+  if (parent.isValid()) {
+    return 0;
+  }
+  return mode == Mode::allRequests ? 6 : 5;
+}
+
+QVariant CreateCompanyRequestTableModel::data(
+  const QModelIndex &index,
+  int role
+) const
+{
+  if (!index.isValid() || role != Qt::DisplayRole) {
+    return QVariant();
+  }
+
+  static std::unordered_map<CreateCompanyRequestStatus, QString> statusIdToStatusString {
+    {CreateCompanyRequestStatus::Accepted, "Accepted"},
+    {CreateCompanyRequestStatus::Cancelled, "Cancelled"},
+    {CreateCompanyRequestStatus::Denied, "Denied"},
+    {CreateCompanyRequestStatus::Posted, "Posted"},
+  };
+
+  auto row = index.row();
+
+  switch (ToColumn(index.column(), mode)) {
+    case companyNameColumn: return companyNames[row];
+    case requesterColumn: return requesterUsernames[row];
+    case requestDateColumn: return FormatColumnDate(requestDates[row]);
+    case statusColumn: return statusIdToStatusString[CreateCompanyRequestStatus(statuses[row])];
+    case statusChangeDateColumn: return FormatColumnDate(statusChangeDates[row]);
+    case statusChangerColumn: return statusChangerUsernames[row];
+  }
+  return QVariant();
+}
+
+QVariant CreateCompanyRequestTableModel::headerData(
+  int section,
+  Qt::Orientation orientation,
+  int role
+) const
+{
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+    return QAbstractTableModel::headerData(section, orientation, role);
+  }
+
+  static const QStringList labels {
+    "Company name",
+    "Requester",
+    "Request date",
+    "Status",
+    "Status change date",
+    "Status changer"
+  };
+  return labels.value(ToColumn(section, mode));
+}
@@ -0,0 +1,141 @@
+#include "JobOpeningTableModel.h"
+
+#include <unordered_map>
+
+JobOpeningTableModel::JobOpeningTableModel(
+  std::optional<JobOpeningModel::JobOpeningStatus> status,
+  std::optional<CompanyID> companyId,
+  std::optional<UserID> creatorId,
+  QObject *parent
+)
+  : KeysetTableModel(200, parent)
+  , status(status)
+  , companyId(companyId)
+  , creatorId(creatorId)
+{}
+
+QFuture<JobOpeningModel::JobOpeningListPage> JobOpeningTableModel::LoadPage(
+  std::optional<JobOpeningModel::JobOpeningCursor> after,
+  int limit
+) const
+{
+  if (!searchText.isEmpty()) {
+    return JobOpeningModel::SearchJobOpeningsAsync(searchText, {status, companyId, creatorId}, after, limit);
+  }
+  return JobOpeningModel::LoadJobOpeningListPageAsync(status, companyId, creatorId, after, limit);
+}
+
+void JobOpeningTableModel::SetSearchText(
+  QString text
+)
+{
+  searchText = std::move(text);
+}
+
+void JobOpeningTableModel::ClearColumns()
+{
+  ids.clear();
+  titles.clear();
+  companyIds.clear();
+  companyNames.clear();
+  createDates.clear();
+  creatorIds.clear();
+  creatorUsernames.clear();
+  statuses.clear();
+  statusChangeDates.clear();
+  statusChangerUsernames.clear();
+}
+
+void JobOpeningTableModel::AppendToColumns(
+  const QList<JobOpeningModel::JobOpeningListData>& rows
+)
+{
+  for (auto& row : rows) {
+    ids.append(row.id);
+    titles.append(row.title);
+    companyIds.append(row.companyId);
+    companyNames.append(row.companyName);
+    createDates.append(ToColumnDate(row.createDate));
+    creatorIds.append(row.creatorId);
+    creatorUsernames.append(row.creatorUsername);
+    statuses.append(quint8(row.status));
+    statusChangeDates.append(ToColumnDate(row.statusChangeDate));
+    statusChangerUsernames.append(row.statusChangerUsername);
+  }
+}
+
+JobOpeningModel::JobOpeningListData JobOpeningTableModel::RowAt(
+  int row
+) const
+{
+  JobOpeningModel::JobOpeningListData data;
+
+  data.id = ids[row];
+  data.title = titles[row];
+  data.companyId = companyIds[row];
+  data.companyName = companyNames[row];
+  data.createDate = QDateTime::fromMSecsSinceEpoch(createDates[row]);
+  data.creatorId = creatorIds[row];
+  data.creatorUsername = creatorUsernames[row];
+  data.status = JobOpeningModel::JobOpeningStatus(statuses[row]);
+  data.statusChangeDate = QDateTime::fromMSecsSinceEpoch(statusChangeDates[row]);
+  data.statusChangerUsername = statusChangerUsernames[row];
+  return data;
+}
+
+int JobOpeningTableModel::columnCount(
+  const QModelIndex &parent
+) const
+{
+  return parent.isValid() ? 0 : 7; // without description
+}
+
+QVariant JobOpeningTableModel::data(
+  const QModelIndex &index,
+  int role
+) const
+{
+  if (!index.isValid() || role != Qt::DisplayRole) {
+    return QVariant();
+  }
+
+  static std::unordered_map<JobOpeningModel::JobOpeningStatus, QString> statusIdToStatusString {
+    {JobOpeningModel::JobOpeningStatus::Closed, "Closed"},
+    {JobOpeningModel::JobOpeningStatus::Posted, "Open"},
+  };
+
+  auto row = index.row();
+
+  switch (index.column()) {
+    case 0: return titles[row];
+    case 1: return companyNames[row].isEmpty() ? "ERROR COMPANY" : companyNames[row];
+    case 2: return FormatColumnDate(createDates[row]);
+    case 3: return creatorUsernames[row].isEmpty() ? "ERROR USER" : creatorUsernames[row];
+    case 4: return statusIdToStatusString[JobOpeningModel::JobOpeningStatus(statuses[row])];
+    case 5: return FormatColumnDate(statusChangeDates[row]);
+    case 6: return statusChangerUsernames[row].isEmpty() ? "ERROR USER" : statusChangerUsernames[row];
+  }
+  return QVariant();
+}
+
+QVariant JobOpeningTableModel::headerData(
+  int section,
+  Qt::Orientation orientation,
+  int role
+) const
+{
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+    return QAbstractTableModel::headerData(section, orientation, role);
+  }
+
+  static const QStringList labels {
+    "Job Title",
+    "Company",
+    "Create date",
+    "Creator",
+    "Status",
+    "Status change date",
+    "Status changer"
+  };
+  return labels.value(section);
+}
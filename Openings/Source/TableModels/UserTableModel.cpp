@@ -0,0 +1,109 @@
+#include "UserTableModel.h"
+
+UserTableModel::UserTableModel(
+  QObject *parent
+)
+  : KeysetTableModel(200, parent)
+{}
+
+QFuture<UserModel::UserPage> UserTableModel::LoadPage(
+  std::optional<UserModel::UserCursor> after,
+  int limit
+) const
+{
+  if (!searchText.isEmpty()) {
+    return UserModel::SearchUsersAsync(searchText, after, limit);
+  }
+  return UserModel::LoadUsersPageAsync(after, limit);
+}
+
+bool UserTableModel::SetSearchText(
+  QString text
+)
+{
+  if (text.size() < TRIGRAM_SEARCH_MIN_SIZE) {
+    text.clear();
+  }
+  if (text == searchText) {
+    return false;
+  }
+  searchText = std::move(text);
+  return true;
+}
+
+void UserTableModel::ClearColumns()
+{
+  ids.clear();
+  usernames.clear();
+  names.clear();
+  registrationDates.clear();
+}
+
+void UserTableModel::AppendToColumns(
+  const QList<UserModel::UserData>& rows
+)
+{
+  for (auto& row : rows) {
+    ids.append(row.id);
+    usernames.append(row.username);
+    names.append(row.name);
+    registrationDates.append(ToColumnDate(row.registrationDate));
+  }
+}
+
+UserModel::UserData UserTableModel::RowAt(
+  int row
+) const
+{
+  UserModel::UserData data;
+
+  data.id = ids[row];
+  data.username = usernames[row];
+  data.name = names[row];
+  data.registrationDate = QDateTime::fromMSecsSinceEpoch(registrationDates[row]);
+  return data;
+}
+
+int UserTableModel::columnCount(
+  const QModelIndex &parent
+) const
+{
+  return parent.isValid() ? 0 : 3;
+}
+
+QVariant UserTableModel::data(
+  const QModelIndex &index,
+  int role
+) const
+{
+  if (!index.isValid() || role != Qt::DisplayRole) {
+    return QVariant();
+  }
+
+  auto row = index.row();
+
+  switch (index.column()) {
+    case 0: return usernames[row];
+    case 1: return names[row];
+    case 2: return FormatColumnDate(registrationDates[row]);
+  }
+  return QVariant();
+}
+
+QVariant UserTableModel::headerData(
+  int section,
+  Qt::Orientation orientation,
+  int role
+) const
+{
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+    return QAbstractTableModel::headerData(section, orientation, role);
+  }
+
+  static const QStringList labels {
+    "Username",
+    "Name",
+    "Registration date"
+  };
+  return labels.value(section);
+}
@@ -0,0 +1,22 @@
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+CONFIG += c++20 console
+CONFIG -= app_bundle
+QT += core sql
+QT -= gui
+CONFIG += link_pkgconfig
+PKGCONFIG += libpq # COPY is not exposed by QtSql
+
+APP = ../..
+
+SOURCES += \
+    main.cpp \
+    \
+    $$APP/Source/CopyIn.cpp
+
+HEADERS += \
+    $$APP/Headers/Common.h \
+    $$APP/Headers/CopyIn.h
+
+INCLUDEPATH += \
+    $$APP/Headers \
+    $$APP/Headers/Models
@@ -0,0 +1,797 @@
+#include "CopyIn.h"
+#include "Common.h"
+#include "ApplicationModel.h"
+#include "JobOpeningModel.h"
+#include "UserResumeModel.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Fills an empty Openings database with synthetic data at production
+// scale through COPY:
+//
+//   DataGen db_settings.json [--users 1000000] [--applications 10000000] ...
+//
+// Popularity is skewed: low ids get most of the openings, workers and
+// applications, the way a few large companies dominate real traffic.
+// Every generated user has the password "password".
+// Indexes and foreign keys of the loaded tables are dropped for the load
+// and rebuilt once it is done; the primary keys stay.
+// A share of the resume contents is text, stored with the Zlib codec as
+// uploads of such files are; the run ends by timing resume downloads.
+
+namespace  {
+  using Random = std::mt19937_64;
+
+  struct Sizes {
+    int users;
+    int companies;
+    int openings;
+    int resumes;
+    int resumeContents;
+    qint64 applications;
+    double skew;
+    double compressible; // share of resume contents that are text
+  };
+
+  const char* const firstNames[] = {
+    "Anna", "Boris", "Chloe", "Daniel", "Elena", "Fedor", "Grace", "Hugo",
+    "Irina", "James", "Kira", "Leo", "Maria", "Nikita", "Olga", "Pavel",
+    "Quinn", "Roman", "Sofia", "Timur", "Uma", "Victor", "Wendy", "Yana"
+  };
+  const char* const lastNames[] = {
+    "Ivanov", "Smith", "Petrova", "Johnson", "Sokolov", "Brown", "Kuznetsova",
+    "Garcia", "Popov", "Miller", "Volkova", "Davis", "Morozov", "Wilson",
+    "Novikova", "Moore", "Fedorov", "Taylor", "Orlova", "Anderson"
+  };
+  const char* const companyWords[] = {
+    "Blue", "North", "Quantum", "Silver", "Bright", "Rapid", "Green", "Prime",
+    "Atlas", "Nova", "Cedar", "Vector", "Summit", "Harbor", "Pixel", "Delta"
+  };
+  const char* const companySuffixes[] = {
+    "Labs", "Systems", "Group", "Soft", "Works", "Partners", "Logistics", "Health"
+  };
+  const char* const positions[] = {
+    "Backend developer", "Frontend developer", "Data analyst", "QA engineer",
+    "DevOps engineer", "Product manager", "Designer", "Support engineer",
+    "Accountant", "Sales manager", "HR specialist", "Team lead"
+  };
+  const char* const levels[] = {"Junior", "Middle", "Senior", "Lead"};
+  const char* const loadedTables[] = {
+    "openings_user", "openings_company", "openings_user_to_company_permission",
+    "openings_job_opening", "openings_resume_content", "openings_resume_chunk",
+    "openings_user_resume", "openings_job_opening_application"
+  };
+  const char* const resumeWords[] = {
+    "experience", "project", "team", "developed", "managed", "responsible",
+    "for", "the", "and", "with", "years", "of", "skills", "education",
+    "university", "languages", "English", "SQL", "customers", "reports",
+    "improved", "performance", "migration", "led", "support", "designed"
+  };
+
+  template <class T, size_t N>
+  const T& Pick(
+    Random& random,
+    const T (&values)[N]
+  )
+  {
+    return values[std::uniform_int_distribution<size_t>(0, N - 1)(random)];
+  }
+
+  // Index in [0, n), u^skew pushes it toward 0; skew 1 is uniform.
+  int Skewed(
+    Random& random,
+    int n,
+    double skew
+  )
+  {
+    auto u = std::uniform_real_distribution<double>(0, 1)(random);
+    return std::min(n - 1, int(n * std::pow(u, skew)));
+  }
+
+  bool Chance(
+    Random& random,
+    double probability
+  )
+  {
+    return std::uniform_real_distribution<double>(0, 1)(random) < probability;
+  }
+
+  qint64 Between(
+    Random& random,
+    qint64 from,
+    qint64 to
+  )
+  {
+    return std::uniform_int_distribution<qint64>(from, to)(random);
+  }
+
+  // Formatting through QDateTime dominates the copy of the large tables.
+  QByteArray Timestamp(
+    qint64 secsSinceEpoch
+  )
+  {
+    std::time_t time = secsSinceEpoch;
+    std::tm parts;
+    gmtime_r(&time, &parts);
+
+    char text[32];
+    auto size = std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S+00", &parts);
+    return QByteArray(text, qsizetype(size));
+  }
+
+  QByteArray Bytea(
+    const QByteArray& blob
+  )
+  {
+    return "\\\\x" + blob.toHex();
+  }
+
+  // Same hash as UserModel computes for a password.
+  QByteArray PasswordHash(
+    QString password
+  )
+  {
+    QCryptographicHash hasher(QCryptographicHash::Sha256);
+    auto wstr = password.toStdU32String();
+    hasher.addData(reinterpret_cast<char*>(wstr.data()), wstr.length());
+    return hasher.result();
+  }
+
+  // Resume sizes are log-normal around 120 KB. Most contents are random
+  // bytes, which don't compress, like the PDFs most resumes are; the
+  // compressible share is plain text, which the Zlib codec is for.
+  QByteArray ResumeContent(
+    quint64 seed,
+    int index,
+    double compressible
+  )
+  {
+    Random random(seed ^ (quint64(index) * 0x9E3779B97F4A7C15ull));
+    std::lognormal_distribution<double> sizes(std::log(120.0 * 1024), 0.8);
+    auto size = std::clamp(qint64(sizes(random)), qint64(8 * 1024), qint64(4 * 1024 * 1024));
+
+    if (Chance(random, compressible)) {
+      QByteArray text;
+      text.reserve(size + 64);
+      for (int words = 1; text.size() < size; ++words) {
+        text += Chance(random, 0.1) ? Pick(random, positions) : Pick(random, resumeWords);
+        text += words % 12 == 0 ? '\n' : ' ';
+      }
+      text.truncate(size);
+      return text;
+    }
+
+    QByteArray content(size, Qt::Uninitialized);
+    for (qint64 i = 0; i < size; i += 8) {
+      auto bits = random();
+      std::memcpy(content.data() + i, &bits, size_t(std::min<qint64>(8, size - i)));
+    }
+    return content;
+  }
+
+  // Same rule as UserResumeModel applies to the uploaded chunks.
+  std::pair<UserResumeModel::ResumeCodec, QByteArray> EncodeChunk(
+    const QByteArray& chunk
+  )
+  {
+    auto compressed = qCompress(chunk, UserResumeModel::resumeCompressionLevel);
+    if (compressed.size() < chunk.size() - chunk.size() / 8) {
+      return {UserResumeModel::ResumeCodec::Zlib, compressed};
+    }
+    return {UserResumeModel::ResumeCodec::None, chunk};
+  }
+
+  QTextStream& Out()
+  {
+    static QTextStream out(stdout);
+    return out;
+  }
+
+  // Foreign key or index that is dropped for the load and built once from
+  // the loaded rows, instead of being maintained row by row.
+  struct DeferredObject {
+    bool foreignKey;
+    QString name;
+    QString dropSql;
+    QString createSql;
+  };
+
+  class Generator final
+  {
+    QSqlDatabase db;
+    Sizes sizes;
+    quint64 seed;
+    Random random;
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+
+    std::vector<int> companyAdmins;
+    std::vector<std::vector<int>> companyWorkers;
+    std::vector<int> openingCreators;
+    std::vector<qint64> openingDates;
+    std::vector<int> resumeOwners;
+    std::vector<QByteArray> contentHashes;
+
+    void Report(
+      const char* table,
+      qint64 rows,
+      const QElapsedTimer& timer
+    )
+    {
+      Out() << table << ": " << rows << " rows in " << timer.elapsed() / 1000.0 << " s\n";
+      Out().flush();
+    }
+
+    void GenerateUsers();
+    void GenerateCompanies();
+    void GenerateCompanyPermissions();
+    void GenerateOpenings();
+    void GenerateResumes();
+    void GenerateApplications();
+    std::vector<DeferredObject> DropDeferredObjects();
+    void CreateDeferredObjects(const std::vector<DeferredObject>& objects);
+    void MeasureResumeDownloads();
+
+  public:
+    Generator(QSqlDatabase db, Sizes sizes, quint64 seed)
+      : db(db)
+      , sizes(sizes)
+      , seed(seed)
+      , random(seed)
+    {}
+
+    void Run();
+  };
+
+  void Generator::GenerateUsers()
+  {
+    QElapsedTimer timer;
+    timer.start();
+
+    auto passwordHash = Bytea(PasswordHash("password"));
+    auto hashAlg = QByteArray::number(int(QCryptographicHash::Sha256));
+    // registrations grow over five years in id order
+    auto firstRegistration = now - qint64(5) * 365 * 24 * 3600;
+    auto step = double(now - firstRegistration) / sizes.users;
+
+    CopyIn copy(db,
+                "COPY openings_user "
+                "(id, username, name, registration_date, password_hash, hash_alg) "
+                "FROM STDIN");
+    for (int id = 1; id <= sizes.users; ++id) {
+      copy.AddField(id);
+      copy.AddField("user" + QString::number(id));
+      copy.AddField(QString(Pick(random, firstNames)) + " " + Pick(random, lastNames));
+      copy.AddRawField(Timestamp(firstRegistration + qint64(step * id) + Between(random, 0, 3600)));
+      copy.AddRawField(passwordHash);
+      copy.AddRawField(hashAlg);
+      copy.EndRow();
+    }
+    Report("openings_user", copy.Finish(), timer);
+  }
+
+  void Generator::GenerateCompanies()
+  {
+    QElapsedTimer timer;
+    timer.start();
+
+    CopyIn copy(db,
+                "COPY openings_company (id, name, id_company_admin) "
+                "FROM STDIN");
+    for (int id = 1; id <= sizes.companies; ++id) {
+      auto admin = int(Between(random, 1, sizes.users));
+      companyAdmins.push_back(admin);
+
+      copy.AddField(id);
+      copy.AddField(QString(Pick(random, companyWords)) + " " +
+                    Pick(random, companyWords) + " " +
+                    Pick(random, companySuffixes) + " " +
+                    QString::number(id));
+      copy.AddField(admin);
+      copy.EndRow();
+    }
+    Report("openings_company", copy.Finish(), timer);
+  }
+
+  void Generator::GenerateCompanyPermissions()
+  {
+    QElapsedTimer timer;
+    timer.start();
+
+    CopyIn copy(db,
+                "COPY openings_user_to_company_permission (id_user, id_permission, id_company) "
+                "FROM STDIN");
+    companyWorkers.resize(sizes.companies);
+    for (int company = 0; company < sizes.companies; ++company) {
+      // the largest companies, the low ids, employ up to a few hundred recruiters
+      auto large = company < std::max(1, sizes.companies / 100);
+      auto count = std::min(sizes.users, 1 + Skewed(random, large ? 300 : 5, sizes.skew));
+      auto& workers = companyWorkers[company];
+      while (int(workers.size()) < count) {
+        auto user = int(Between(random, 1, sizes.users));
+        if (std::find(workers.begin(), workers.end(), user) != workers.end()) {
+          continue;
+        }
+        workers.push_back(user);
+
+        copy.AddField(user);
+        copy.AddField(1); // Work with openings
+        copy.AddField(company + 1);
+        copy.EndRow();
+      }
+    }
+    Report("openings_user_to_company_permission", copy.Finish(), timer);
+  }
+
+  void Generator::GenerateOpenings()
+  {
+    QElapsedTimer timer;
+    timer.start();
+
+    CopyIn copy(db,
+                "COPY openings_job_opening "
+                "(id, title, description, id_company, create_date, id_creator, "
+                " opening_status, status_change_date, id_status_changer) "
+                "FROM STDIN");
+    for (int id = 1; id <= sizes.openings; ++id) {
+      auto company = Skewed(random, sizes.companies, sizes.skew);
+      auto& workers = companyWorkers[company];
+      auto creator = Chance(random, 0.2) ? companyAdmins[company]
+                                         : workers[Between(random, 0, qint64(workers.size()) - 1)];
+      auto created = now - Between(random, 0, qint64(3) * 365 * 24 * 3600);
+      // most openings older than a few months are closed
+      auto closed = Chance(random, std::min(0.9, double(now - created) / (180.0 * 24 * 3600)));
+      auto changed = closed ? created + Between(random, 3600, std::max<qint64>(3600, now - created)) : created;
+
+      openingCreators.push_back(creator);
+      openingDates.push_back(created);
+
+      QString title = QString(Pick(random, levels)) + " " + Pick(random, positions);
+      copy.AddField(id);
+      copy.AddField(title);
+      if (Chance(random, 0.1)) {
+        copy.AddNull();
+      }
+      else {
+        copy.AddField(title + " wanted. Remote or office, full time, salary by agreement.");
+      }
+      copy.AddField(company + 1);
+      copy.AddRawField(Timestamp(created));
+      copy.AddField(creator);
+      copy.AddField(int(closed ? JobOpeningModel::JobOpeningStatus::Closed
+                               : JobOpeningModel::JobOpeningStatus::Posted));
+      copy.AddRawField(Timestamp(changed));
+      copy.AddField(creator);
+      copy.EndRow();
+    }
+    Report("openings_job_opening", copy.Finish(), timer);
+  }
+
+  void Generator::GenerateResumes()
+  {
+    QElapsedTimer timer;
+    timer.start();
+
+    // Contents are shared by hash, so many resumes point at one content.
+    // The bytes are generated twice from the same seed: once for the
+    // content rows and once for their chunks, which need them to exist.
+    {
+      CopyIn copy(db,
+                  "COPY openings_resume_content (content_hash, size, chunk_count) "
+                  "FROM STDIN");
+      for (int index = 0; index < sizes.resumeContents; ++index) {
+        auto content = ResumeContent(seed, index, sizes.compressible);
+        contentHashes.push_back(QCryptographicHash::hash(content, QCryptographicHash::Sha256));
+
+        copy.AddRawField(Bytea(contentHashes.back()));
+        copy.AddRawField(QByteArray::number(content.size()));
+        copy.AddField(int((content.size() + UserResumeModel::resumeChunkSize - 1) /
+                          UserResumeModel::resumeChunkSize));
+        copy.EndRow();
+      }
+      Report("openings_resume_content", copy.Finish(), timer);
+    }
+
+    timer.restart();
+
+    {
+      qint64 rawBytes = 0;
+      qint64 storedBytes = 0;
+      qint64 zlibChunks = 0;
+
+      CopyIn copy(db,
+                  "COPY openings_resume_chunk (content_hash, chunk_no, codec, blob) "
+                  "FROM STDIN");
+      for (int index = 0; index < sizes.resumeContents; ++index) {
+        auto content = ResumeContent(seed, index, sizes.compressible);
+        auto hash = Bytea(contentHashes[index]);
+        for (qint64 offset = 0, chunkNo = 0; offset < content.size();
+             offset += UserResumeModel::resumeChunkSize, ++chunkNo) {
+          auto [codec, stored] = EncodeChunk(content.mid(offset, UserResumeModel::resumeChunkSize));
+          rawBytes += std::min<qint64>(UserResumeModel::resumeChunkSize, content.size() - offset);
+          storedBytes += stored.size();
+          zlibChunks += codec == UserResumeModel::ResumeCodec::Zlib ? 1 : 0;
+
+          copy.AddRawField(hash);
+          copy.AddField(int(chunkNo));
+          copy.AddField(int(codec));
+          copy.AddRawField(Bytea(stored));
+          copy.EndRow();
+        }
+      }
+      Report("openings_resume_chunk", copy.Finish(), timer);
+      Out() << "  " << rawBytes / (1024 * 1024) << " MiB of contents stored in "
+            << storedBytes / (1024 * 1024) << " MiB, "
+            << zlibChunks << " chunks compressed\n";
+    }
+
+    timer.restart();
+
+    CopyIn copy(db,
+                "COPY openings_user_resume (id, filename, content_hash, id_user) "
+                "FROM STDIN");
+    for (int id = 1; id <= sizes.resumes; ++id) {
+      // active job seekers keep several versions
+      auto owner = 1 + Skewed(random, sizes.users, 1.5);
+      resumeOwners.push_back(owner);
+
+      copy.AddField(id);
+      copy.AddField("resume_" + QString::number(id) + (Chance(random, 0.7) ? ".pdf" : ".docx"));
+      copy.AddRawField(Bytea(contentHashes[Skewed(random, sizes.resumeContents, sizes.skew)]));
+      copy.AddField(owner);
+      copy.EndRow();
+    }
+    Report("openings_user_resume", copy.Finish(), timer);
+  }
+
+  void Generator::GenerateApplications()
+  {
+    QElapsedTimer timer;
+    timer.start();
+
+    using ApplicationModel::ApplicationStatusID;
+
+    CopyIn copy(db,
+                "COPY openings_job_opening_application "
+                "(id, id_resume, id_opening, application_date, application_status, "
+                " status_change_date, id_status_changer) "
+                "FROM STDIN");
+    for (qint64 id = 1; id <= sizes.applications; ++id) {
+      auto resume = int(Between(random, 0, sizes.resumes - 1));
+      auto opening = Skewed(random, sizes.openings, sizes.skew);
+      auto applied = std::min(now, openingDates[opening] + Between(random, 0, qint64(60) * 24 * 3600));
+
+      // half are still waiting, most of the decided ones are denied
+      auto roll = std::uniform_real_distribution<double>(0, 1)(random);
+      auto status = roll < 0.5 ? ApplicationStatusID::Posted
+                  : roll < 0.6 ? ApplicationStatusID::Cancelled
+                  : roll < 0.72 ? ApplicationStatusID::Accepted
+                  : ApplicationStatusID::Denied;
+      auto changer = status == ApplicationStatusID::Posted || status == ApplicationStatusID::Cancelled
+                       ? resumeOwners[resume]
+                       : openingCreators[opening];
+      auto changed = status == ApplicationStatusID::Posted
+                       ? applied
+                       : std::min(now, applied + Between(random, 3600, qint64(14) * 24 * 3600));
+
+      copy.AddRawField(QByteArray::number(id));
+      copy.AddField(resume + 1);
+      copy.AddField(opening + 1);
+      copy.AddRawField(Timestamp(applied));
+      copy.AddField(int(status));
+      copy.AddRawField(Timestamp(changed));
+      copy.AddField(changer);
+      copy.EndRow();
+    }
+    Report("openings_job_opening_application", copy.Finish(), timer);
+  }
+
+  // The primary keys and unique constraints stay, the foreign keys point
+  // at them and the generator relies on them for its ids.
+  std::vector<DeferredObject> Generator::DropDeferredObjects()
+  {
+    QStringList tables;
+    for (auto table : loadedTables) {
+      tables.append(table);
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.prepare("WITH T AS ( "
+                       "  SELECT unnest(CAST(:tables AS regclass[])) AS id "
+                       ") "
+                       "SELECT "
+                       "  FALSE, " // 0
+                       "  I.indexrelid::regclass::text, " // 1
+                       "  format('DROP INDEX %s', I.indexrelid::regclass), " // 2
+                       "  pg_get_indexdef(I.indexrelid) " // 3
+                       "FROM pg_index AS I "
+                       "JOIN T ON T.id=I.indrelid "
+                       "WHERE NOT EXISTS (SELECT 1 FROM pg_constraint AS C "
+                       "                  WHERE C.conindid=I.indexrelid) "
+                       "UNION ALL "
+                       "SELECT "
+                       "  TRUE, "
+                       "  C.conname::text, "
+                       "  format('ALTER TABLE %s DROP CONSTRAINT %I', C.conrelid::regclass, C.conname), "
+                       "  format('ALTER TABLE %s ADD CONSTRAINT %I %s', "
+                       "         C.conrelid::regclass, C.conname, pg_get_constraintdef(C.oid)) "
+                       "FROM pg_constraint AS C "
+                       "JOIN T ON T.id=C.conrelid "
+                       "WHERE C.contype='f'")) {
+      throw std::runtime_error("Error while preparing the index lookup.\n" +
+                               query.lastError().text().toStdString());
+    }
+    query.bindValue(":tables", "{" + tables.join(",") + "}");
+    if (!query.exec()) {
+      throw std::runtime_error("Error while looking up the indexes.\n" +
+                               query.lastError().text().toStdString());
+    }
+
+    std::vector<DeferredObject> objects;
+    while (query.next()) {
+      objects.push_back({query.value(0).toBool(),
+                         query.value(1).toString(),
+                         query.value(2).toString(),
+                         query.value(3).toString()});
+    }
+    // indexes are rebuilt before the foreign keys are validated
+    std::stable_partition(objects.begin(), objects.end(), [] (const DeferredObject& object) {
+      return !object.foreignKey;
+    });
+
+    QSqlQuery drop(db);
+    for (auto object = objects.rbegin(); object != objects.rend(); ++object) {
+      if (!drop.exec(object->dropSql)) {
+        throw std::runtime_error("Error while dropping the indexes.\n" +
+                                 drop.lastError().text().toStdString());
+      }
+    }
+    Out() << "Dropped " << qint64(objects.size()) << " indexes and foreign keys\n";
+    return objects;
+  }
+
+  void Generator::CreateDeferredObjects(
+    const std::vector<DeferredObject>& objects
+  )
+  {
+    QSqlQuery query(db);
+    // index builds sort in memory up to this size
+    query.exec("SET LOCAL maintenance_work_mem TO '512MB'");
+
+    QElapsedTimer timer;
+    for (auto& object : objects) {
+      timer.start();
+      if (!query.exec(object.createSql)) {
+        throw std::runtime_error("Error while recreating the indexes.\n" +
+                                 query.lastError().text().toStdString());
+      }
+      Out() << (object.foreignKey ? "foreign key " : "index ") << object.name
+            << " in " << timer.elapsed() / 1000.0 << " s\n";
+      Out().flush();
+    }
+  }
+
+  // Downloads a sample of the popular contents chunk by chunk, the way
+  // UserResumeModel::DownloadUserResume does, and reports the bytes read
+  // from the server against the bytes of the files.
+  void Generator::MeasureResumeDownloads()
+  {
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.prepare("SELECT codec, blob "
+                       "FROM openings_resume_chunk "
+                       "WHERE content_hash=:content_hash "
+                       "AND chunk_no=:chunk_no")) {
+      throw std::runtime_error("Error while preparing the resume download.\n" +
+                               query.lastError().text().toStdString());
+    }
+
+    const int downloads = std::min(100, sizes.resumeContents);
+    qint64 wireBytes = 0;
+    qint64 fileBytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int download = 0; download < downloads; ++download) {
+      auto hash = contentHashes[Skewed(random, sizes.resumeContents, sizes.skew)];
+      for (int chunkNo = 0; ; ++chunkNo) {
+        query.bindValue(":content_hash", hash);
+        query.bindValue(":chunk_no", chunkNo);
+        if (!query.exec()) {
+          throw std::runtime_error("Error while downloading a resume.\n" +
+                                   query.lastError().text().toStdString());
+        }
+        if (!query.next()) {
+          break;
+        }
+
+        auto stored = query.value(1).toByteArray();
+        auto codec = UserResumeModel::ResumeCodec(query.value(0).toInt());
+        auto chunk = codec == UserResumeModel::ResumeCodec::Zlib ? qUncompress(stored) : stored;
+        wireBytes += stored.size();
+        fileBytes += chunk.size();
+      }
+    }
+    Out() << "Resume download: " << downloads << " files, "
+          << fileBytes / downloads / 1024 << " KiB per file, "
+          << wireBytes / downloads / 1024 << " KiB read, "
+          << double(timer.elapsed()) / downloads << " ms per file\n";
+  }
+
+  void Generator::Run()
+  {
+    QSqlQuery query(db);
+    if (!query.exec("SELECT EXISTS (SELECT 1 FROM openings_user) "
+                    "OR EXISTS (SELECT 1 FROM openings_company) "
+                    "OR EXISTS (SELECT 1 FROM openings_resume_content)") ||
+        !query.next()) {
+      throw std::runtime_error("Error while checking the tables.\n" +
+                               query.lastError().text().toStdString());
+    }
+    if (query.value(0).toBool()) {
+      throw std::runtime_error("The tables already contain data, the generator fills empty ones only");
+    }
+
+    // a crash only loses the dataset being generated
+    query.exec("SET synchronous_commit TO off");
+
+    // One transaction, so a failed load rolls back its rows together with
+    // the dropped indexes and foreign keys; an error closes the connection,
+    // which rolls it back.
+    if (!db.transaction()) {
+      throw std::runtime_error("Error while starting the load.\n" +
+                               db.lastError().text().toStdString());
+    }
+    auto deferred = DropDeferredObjects();
+
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    GenerateUsers();
+    GenerateCompanies();
+    GenerateCompanyPermissions();
+    GenerateOpenings();
+    GenerateResumes();
+    GenerateApplications();
+    Out() << "Rows copied in " << loadTimer.elapsed() / 1000.0 << " s\n";
+
+    loadTimer.restart();
+    CreateDeferredObjects(deferred);
+    Out() << "Indexes and foreign keys built in " << loadTimer.elapsed() / 1000.0 << " s\n";
+
+    // ids were copied explicitly, the sequences continue after them
+    for (auto table : {"openings_user", "openings_company", "openings_job_opening",
+                       "openings_user_resume", "openings_job_opening_application"}) {
+      if (!query.exec(QString("SELECT setval(pg_get_serial_sequence('%1', 'id'), "
+                              "(SELECT MAX(id) FROM %1))").arg(table))) {
+        throw std::runtime_error("Error while advancing the id sequences.\n" +
+                                 query.lastError().text().toStdString());
+      }
+    }
+    if (!db.commit()) {
+      throw std::runtime_error("Error while committing the load.\n" +
+                               db.lastError().text().toStdString());
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!query.exec("ANALYZE")) {
+      throw std::runtime_error("Error while analyzing the tables.\n" +
+                               query.lastError().text().toStdString());
+    }
+    Out() << "ANALYZE in " << timer.elapsed() / 1000.0 << " s\n";
+
+    MeasureResumeDownloads();
+  }
+
+  QSqlDatabase OpenDatabase(
+    const QString& settingsPath
+  )
+  {
+    QFile settingsFile(settingsPath);
+    if (!settingsFile.open(QIODevice::ReadOnly)) {
+      throw std::runtime_error("Error while opening settings file");
+    }
+
+    auto settings = QJsonDocument::fromJson(settingsFile.readAll()).object();
+    for (auto key : {"host", "databaseName", "username", "password", "port"}) {
+      if (!settings[key].isString()) {
+        throw std::runtime_error("Incorrect format of settings object");
+      }
+    }
+
+    auto db = QSqlDatabase::addDatabase("QPSQL");
+    db.setHostName(settings["host"].toString());
+    db.setDatabaseName(settings["databaseName"].toString());
+    db.setUserName(settings["username"].toString());
+    db.setPort(settings["port"].toString().toInt());
+    db.setPassword(settings["password"].toString());
+    if (!db.open()) {
+      throw std::runtime_error("Error while connection to the database.\n" +
+                               db.lastError().text().toStdString());
+    }
+    return db;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Fills an empty Openings database with synthetic data.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("settings", "Database settings file of the application.");
+  QCommandLineOption usersOption("users", "Number of users.", "count", "1000000");
+  QCommandLineOption companiesOption("companies", "Number of companies.", "count", "20000");
+  QCommandLineOption openingsOption("openings", "Number of job openings.", "count", "500000");
+  QCommandLineOption resumesOption("resumes", "Number of user resumes.", "count", "1500000");
+  QCommandLineOption contentsOption("resume-contents", "Number of distinct resume files.", "count", "2000");
+  QCommandLineOption applicationsOption("applications", "Number of applications.", "count", "10000000");
+  QCommandLineOption skewOption("skew", "Popularity skew, 1 is uniform.", "factor", "2.5");
+  QCommandLineOption compressibleOption("compressible", "Share of resume contents that compress.", "share", "0.3");
+  QCommandLineOption seedOption("seed", "Random seed.", "seed", "1");
+  parser.addOptions({usersOption, companiesOption, openingsOption, resumesOption,
+                     contentsOption, applicationsOption, skewOption, compressibleOption,
+                     seedOption});
+  parser.process(app);
+
+  if (parser.positionalArguments().size() != 1) {
+    parser.showHelp(-1);
+  }
+
+  Sizes sizes {
+    parser.value(usersOption).toInt(),
+    parser.value(companiesOption).toInt(),
+    parser.value(openingsOption).toInt(),
+    parser.value(resumesOption).toInt(),
+    parser.value(contentsOption).toInt(),
+    parser.value(applicationsOption).toLongLong(),
+    parser.value(skewOption).toDouble(),
+    parser.value(compressibleOption).toDouble()
+  };
+  if (sizes.users < 1 || sizes.companies < 1 || sizes.openings < 1 ||
+      sizes.resumes < 1 || sizes.resumeContents < 1 || sizes.applications < 0 ||
+      sizes.skew < 1 || sizes.compressible < 0 || sizes.compressible > 1) {
+    Out() << "Error. Every count must be positive, the skew at least 1 "
+             "and the compressible share between 0 and 1\n";
+    return -1;
+  }
+
+  try {
+    QElapsedTimer timer;
+    timer.start();
+
+    Generator generator(OpenDatabase(parser.positionalArguments().first()),
+                        sizes,
+                        parser.value(seedOption).toULongLong());
+    generator.Run();
+
+    Out() << "Done in " << timer.elapsed() / 1000.0 << " s\n";
+    Out().flush();
+    return 0;
+  }
+  catch (std::exception& ex) {
+    Out() << "Error. " << ex.what() << "\n";
+    Out().flush();
+    return -1;
+  }
+}
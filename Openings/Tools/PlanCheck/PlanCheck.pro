@@ -0,0 +1,43 @@
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+CONFIG += c++20 console
+CONFIG -= app_bundle
+QT += core sql concurrent
+QT -= gui
+CONFIG += link_pkgconfig
+PKGCONFIG += libpq # COPY is not exposed by QtSql
+
+# The model sources are compiled in so that every statement they declare
+# is registered and explained.
+APP = ../..
+
+SOURCES += \
+    main.cpp \
+    \
+    $$APP/Source/Common.cpp \
+    $$APP/Source/StatementRegistry.cpp \
+    $$APP/Source/DatabasePool.cpp \
+    $$APP/Source/CopyIn.cpp \
+    $$APP/Source/AuthenticatedUser.cpp \
+    $$APP/Source/PermissionSnapshot.cpp \
+    \
+    $$APP/Source/Models/AdminModel.cpp \
+    $$APP/Source/Models/ApplicationModel.cpp \
+    $$APP/Source/Models/CompanyModel.cpp \
+    $$APP/Source/Models/CompanyPermissionModel.cpp \
+    $$APP/Source/Models/JobOpeningModel.cpp \
+    $$APP/Source/Models/UserModel.cpp \
+    $$APP/Source/Models/UserPermissionModel.cpp \
+    $$APP/Source/Models/UserResumeModel.cpp
+
+HEADERS += \
+    $$APP/Headers/Common.h \
+    $$APP/Headers/EntityCache.h \
+    $$APP/Headers/StatementRegistry.h \
+    $$APP/Headers/DatabasePool.h \
+    $$APP/Headers/CopyIn.h \
+    $$APP/Headers/AuthenticatedUser.h \
+    $$APP/Headers/PermissionSnapshot.h
+
+INCLUDEPATH += \
+    $$APP/Headers \
+    $$APP/Headers/Models
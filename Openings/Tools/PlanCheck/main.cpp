@@ -0,0 +1,255 @@
+#include "StatementRegistry.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTextStream>
+
+#include <stdexcept>
+#include <unordered_map>
+
+// Explains every statement declared by the models, including each
+// variant of the statements with optional filters, against a populated
+// database and fails when a plan scans a large table sequentially or
+// costs noticeably more than the stored baseline.
+//
+//   PlanCheck db_settings.json plan_baseline.json [--update]
+//
+// The settings file is the one of the application. Plans of parametrized
+// statements are generic plans, which needs PostgreSQL 16 or newer.
+
+namespace  {
+  struct PlanSummary {
+    double totalCost = 0;
+    QStringList seqScans; // relations read by a Seq Scan node
+  };
+
+  QTextStream& Out()
+  {
+    static QTextStream out(stdout);
+    return out;
+  }
+
+  QSqlDatabase OpenDatabase(
+    const QString& settingsPath
+  )
+  {
+    QFile settingsFile(settingsPath);
+    if (!settingsFile.open(QIODevice::ReadOnly)) {
+      throw std::runtime_error("Error while opening settings file");
+    }
+
+    auto settings = QJsonDocument::fromJson(settingsFile.readAll()).object();
+    for (auto key : {"host", "databaseName", "username", "password", "port"}) {
+      if (!settings[key].isString()) {
+        throw std::runtime_error("Incorrect format of settings object");
+      }
+    }
+
+    auto db = QSqlDatabase::addDatabase("QPSQL");
+    db.setHostName(settings["host"].toString());
+    db.setDatabaseName(settings["databaseName"].toString());
+    db.setUserName(settings["username"].toString());
+    db.setPort(settings["port"].toString().toInt());
+    db.setPassword(settings["password"].toString());
+    if (!db.open()) {
+      throw std::runtime_error("Error while connection to the database.\n" +
+                               db.lastError().text().toStdString());
+    }
+    return db;
+  }
+
+  // Qt placeholders are rewritten on the client, EXPLAIN needs the
+  // server's $n ones. A repeated name maps to the same number.
+  QString ToServerPlaceholders(
+    const QString& sql
+  )
+  {
+    static const QRegularExpression placeholder(R"((?<![:\w]):([A-Za-z_]\w*)|\?)");
+
+    QStringList names;
+    QString result;
+    qsizetype last = 0;
+    auto matches = placeholder.globalMatch(sql);
+    while (matches.hasNext()) {
+      auto match = matches.next();
+      result += sql.mid(last, match.capturedStart() - last);
+
+      auto name = match.captured(1);
+      auto index = name.isEmpty() ? -1 : names.indexOf(name);
+      if (index < 0) {
+        names.append(name);
+        index = names.size() - 1;
+      }
+      result += "$" + QString::number(index + 1);
+      last = match.capturedEnd();
+    }
+    result += sql.mid(last);
+    return result;
+  }
+
+  void CollectPlan(
+    const QJsonObject& node,
+    PlanSummary& summary
+  )
+  {
+    if (node["Node Type"].toString() == "Seq Scan") {
+      summary.seqScans.append(node["Relation Name"].toString());
+    }
+    for (auto child : node["Plans"].toArray()) {
+      CollectPlan(child.toObject(), summary);
+    }
+  }
+
+  PlanSummary Explain(
+    QSqlDatabase db,
+    const QString& sql
+  )
+  {
+    QSqlQuery query(db);
+    if (!query.exec("EXPLAIN (GENERIC_PLAN, FORMAT JSON) " + ToServerPlaceholders(sql)) ||
+        !query.next()) {
+      throw std::runtime_error(query.lastError().text().toStdString());
+    }
+
+    auto plan = QJsonDocument::fromJson(query.value(0).toString().toUtf8())
+                  .array().first().toObject()["Plan"].toObject();
+
+    PlanSummary summary;
+    summary.totalCost = plan["Total Cost"].toDouble();
+    CollectPlan(plan, summary);
+    return summary;
+  }
+
+  std::unordered_map<QString, double> LoadTableRows(
+    QSqlDatabase db
+  )
+  {
+    QSqlQuery query(db);
+    if (!query.exec("SELECT relname, reltuples "
+                    "FROM pg_class "
+                    "WHERE relkind='r' AND relname LIKE 'openings\\_%'")) {
+      throw std::runtime_error("Error while loading table sizes.\n" +
+                               query.lastError().text().toStdString());
+    }
+
+    std::unordered_map<QString, double> rows;
+    while (query.next()) {
+      rows.emplace(query.value(0).toString(), query.value(1).toDouble());
+    }
+    return rows;
+  }
+
+  QJsonObject LoadBaseline(
+    const QString& path
+  )
+  {
+    QFile file(path);
+    if (!file.exists()) {
+      return QJsonObject();
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+      throw std::runtime_error("Error while opening baseline file");
+    }
+    return QJsonDocument::fromJson(file.readAll()).object();
+  }
+
+  void SaveBaseline(
+    const QString& path,
+    const QJsonObject& baseline
+  )
+  {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      throw std::runtime_error("Error while writing baseline file");
+    }
+    file.write(QJsonDocument(baseline).toJson());
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Checks the plans of the Openings model statements.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("settings", "Database settings file of the application.");
+  parser.addPositionalArgument("baseline", "Plan cost baseline, created by --update.");
+  QCommandLineOption updateOption("update", "Store the current costs as the baseline.");
+  QCommandLineOption minRowsOption("min-rows", "Tables from this size on are large.", "rows", "10000");
+  QCommandLineOption toleranceOption("tolerance", "Allowed cost growth over the baseline.", "factor", "1.5");
+  parser.addOptions({updateOption, minRowsOption, toleranceOption});
+  parser.process(app);
+
+  auto arguments = parser.positionalArguments();
+  if (arguments.size() != 2) {
+    parser.showHelp(-1);
+  }
+  auto minRows = parser.value(minRowsOption).toDouble();
+  auto tolerance = parser.value(toleranceOption).toDouble();
+
+  try {
+    auto db = OpenDatabase(arguments[0]);
+    auto tableRows = LoadTableRows(db);
+    auto baseline = LoadBaseline(arguments[1]);
+
+    QJsonObject costs;
+    int failures = 0;
+    int skipped = 0;
+    for (auto& sql : StatementRegistry::Declared()) {
+      PlanSummary summary;
+      try {
+        summary = Explain(db, sql);
+      }
+      catch (std::exception& ex) {
+        // e.g. a parameter whose type the server can't infer
+        Out() << "SKIPPED " << sql << "\n  " << ex.what() << "\n";
+        ++skipped;
+        continue;
+      }
+      costs[sql] = summary.totalCost;
+
+      QStringList problems;
+      for (auto& relation : summary.seqScans) {
+        auto rows = tableRows.find(relation);
+        if (rows != tableRows.end() && rows->second >= minRows) {
+          problems.append(QString("seq scan on %1 (%2 rows)").arg(relation).arg(rows->second));
+        }
+      }
+      auto baselineCost = baseline[sql];
+      if (baselineCost.isDouble() &&
+          summary.totalCost > baselineCost.toDouble() * tolerance) {
+        problems.append(QString("cost %1 over baseline %2")
+                          .arg(summary.totalCost).arg(baselineCost.toDouble()));
+      }
+
+      if (!problems.isEmpty()) {
+        Out() << "FAILED " << sql << "\n  " << problems.join("\n  ") << "\n";
+        ++failures;
+      }
+    }
+
+    if (parser.isSet(updateOption)) {
+      SaveBaseline(arguments[1], costs);
+    }
+
+    Out() << costs.size() << " statements explained, "
+          << failures << " failed, "
+          << skipped << " skipped\n";
+    Out().flush();
+    return failures == 0 ? 0 : 1;
+  }
+  catch (std::exception& ex) {
+    Out() << "Error. " << ex.what() << "\n";
+    Out().flush();
+    return -1;
+  }
+}
@@ -0,0 +1,205 @@
+#include "ApplicationModel.h"
+#include "AuthenticatedUser.h"
+#include "DatabasePool.h"
+#include "StatementRegistry.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTextStream>
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+// Loads the application lists of users with a growing number of rows and
+// fails when a load runs more than one statement, i.e. when the query
+// count grows with the row count instead of staying flat.
+//
+//   QueryCount db_settings.json [--samples 8] [--password password]
+//
+// The users are sampled from a database filled by DataGen, whose users
+// all share one password.
+
+namespace  {
+  using UserRows = std::pair<QString, qint64>; // username, rows of the list
+
+  struct ListLoad {
+    const char* name;
+    const char* rowsSql; // username and row count of every user, ordered by count
+    std::function<qsizetype(AuthenticatedUser)> load;
+  };
+
+  QTextStream& Out()
+  {
+    static QTextStream out(stdout);
+    return out;
+  }
+
+  QSqlDatabase OpenDatabase(
+    const QString& settingsPath
+  )
+  {
+    QFile settingsFile(settingsPath);
+    if (!settingsFile.open(QIODevice::ReadOnly)) {
+      throw std::runtime_error("Error while opening settings file");
+    }
+
+    auto settings = QJsonDocument::fromJson(settingsFile.readAll()).object();
+    for (auto key : {"host", "databaseName", "username", "password", "port"}) {
+      if (!settings[key].isString()) {
+        throw std::runtime_error("Incorrect format of settings object");
+      }
+    }
+
+    auto db = QSqlDatabase::addDatabase("QPSQL");
+    db.setHostName(settings["host"].toString());
+    db.setDatabaseName(settings["databaseName"].toString());
+    db.setUserName(settings["username"].toString());
+    db.setPort(settings["port"].toString().toInt());
+    db.setPassword(settings["password"].toString());
+    if (!db.open()) {
+      throw std::runtime_error("Error while connection to the database.\n" +
+                               db.lastError().text().toStdString());
+    }
+    return db;
+  }
+
+  // Statements executed so far on the connection of the calling thread.
+  qint64 ExecuteCount()
+  {
+    auto connectionName = DatabasePool::Database().connectionName();
+
+    qint64 count = 0;
+    for (auto& stats : StatementRegistry::LoadStats()) {
+      if (stats.connectionName == connectionName) {
+        count += stats.executeCount;
+      }
+    }
+    return count;
+  }
+
+  // Users spread evenly over the row counts, from the smallest list to
+  // the largest one.
+  QList<UserRows> SampleUsers(
+    QSqlDatabase db,
+    const char* rowsSql,
+    int samples
+  )
+  {
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec(rowsSql)) {
+      throw std::runtime_error("Error while counting the list rows.\n" +
+                               query.lastError().text().toStdString());
+    }
+
+    QList<UserRows> users;
+    while (query.next()) {
+      users.append({query.value(0).toString(), query.value(1).toLongLong()});
+    }
+    if (users.size() <= samples) {
+      return users;
+    }
+
+    QList<UserRows> sampled;
+    for (int i = 0; i < samples; ++i) {
+      sampled.append(users[(users.size() - 1) * i / (samples - 1)]);
+    }
+    return sampled;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Counts the statements of the Openings list loads.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("settings", "Database settings file of the application.");
+  QCommandLineOption samplesOption("samples", "Users sampled per list.", "count", "8");
+  QCommandLineOption passwordOption("password", "Password of the sampled users.", "password", "password");
+  parser.addOptions({samplesOption, passwordOption});
+  parser.process(app);
+
+  if (parser.positionalArguments().size() != 1) {
+    parser.showHelp(-1);
+  }
+  auto samples = parser.value(samplesOption).toInt();
+  if (samples < 2) {
+    Out() << "Error. At least 2 samples are needed\n";
+    return -1;
+  }
+
+  const ListLoad loads[] = {
+    {
+      "LoadApplicationListCreatedBy",
+      "SELECT U.username, COUNT(*) AS n "
+      "FROM openings_job_opening_application AS A "
+      "JOIN openings_user_resume AS R ON R.id=A.id_resume "
+      "JOIN openings_user AS U ON U.id=R.id_user "
+      "GROUP BY U.username "
+      "ORDER BY n",
+      [](AuthenticatedUser user) {
+        return ApplicationModel::LoadApplicationListCreatedBy(user, std::nullopt).size();
+      }
+    },
+    {
+      "LoadApplicationListForOpeningsCreatedBy",
+      "SELECT U.username, COUNT(*) AS n "
+      "FROM openings_job_opening_application AS A "
+      "JOIN openings_job_opening AS O ON O.id=A.id_opening "
+      "JOIN openings_user AS U ON U.id=O.id_creator "
+      "GROUP BY U.username "
+      "ORDER BY n",
+      [](AuthenticatedUser user) {
+        return ApplicationModel::LoadApplicationListForOpeningsCreatedBy(user, std::nullopt).size();
+      }
+    }
+  };
+
+  try {
+    auto db = OpenDatabase(parser.positionalArguments().first());
+
+    int failures = 0;
+    for (auto& load : loads) {
+      Out() << load.name << "\n";
+      for (auto& [username, expectedRows] : SampleUsers(db, load.rowsSql, samples)) {
+        auto user = AuthenticatedUser::Login(username, parser.value(passwordOption));
+
+        // the login runs statements of its own, count from here
+        auto before = ExecuteCount();
+        QElapsedTimer timer;
+        timer.start();
+        auto rows = load.load(*user);
+        auto elapsed = timer.nsecsElapsed() / 1e6;
+        auto statements = ExecuteCount() - before;
+
+        auto failed = statements != 1 || rows != expectedRows;
+        Out() << (failed ? "  FAILED " : "  ") << username
+              << ": " << rows << " rows, "
+              << statements << " statements, "
+              << elapsed << " ms\n";
+        if (failed) {
+          ++failures;
+        }
+      }
+    }
+
+    Out() << failures << " loads failed\n";
+    Out().flush();
+    return failures == 0 ? 0 : 1;
+  }
+  catch (std::exception& ex) {
+    Out() << "Error. " << ex.what() << "\n";
+    Out().flush();
+    return -1;
+  }
+}
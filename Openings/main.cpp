@@ -1,4 +1,8 @@
 #include "MainWindow.h"
+#include "StatementRegistry.h"
+#include "DatabasePool.h"
+#include "ResumeCache.h"
+#include "SchemaMigrations.h"
 
 #include <QApplication>
 #include <QMessageBox>
@@ -34,7 +38,11 @@ int main(int argc, char *argv[])
       "databaseName" : "",
       "username" : "",
       "password" : "",
-      "port" : ""
+      "port" : "",
+      "poolSize" : "", // optional
+      "resumeCacheMB" : "", // optional
+      "migrationUsername" : "", // optional, owner of the tables
+      "migrationPassword" : "" // optional
     }
     */
 
@@ -60,12 +68,20 @@ int main(int argc, char *argv[])
     auto username = settingsObject["username"];
     auto password = settingsObject["password"];
     auto port = settingsObject["port"];
+    auto poolSize = settingsObject["poolSize"];
+    auto resumeCacheMB = settingsObject["resumeCacheMB"];
+    auto migrationUsername = settingsObject["migrationUsername"];
+    auto migrationPassword = settingsObject["migrationPassword"];
 
     if (host.isNull() || !host.isString() ||
         databaseName.isNull() || !databaseName.isString() ||
         username.isNull() || !username.isString() ||
         password.isNull() || !password.isString() ||
-        port.isNull() || !port.isString()) {
+        port.isNull() || !port.isString() ||
+        (!poolSize.isUndefined() && !poolSize.isString()) ||
+        (!resumeCacheMB.isUndefined() && !resumeCacheMB.isString()) ||
+        (!migrationUsername.isUndefined() && !migrationUsername.isString()) ||
+        (!migrationPassword.isUndefined() && !migrationPassword.isString())) {
       QMessageBox::critical( nullptr, "Error", "Incorrect format of settings object" );
       return -1;
     }
@@ -89,6 +105,62 @@ int main(int argc, char *argv[])
                              db.lastError().text() );
       return -1;
     }
+
+    // statements are prepared against the migrated schema
+    if (SchemaMigrations::CurrentVersion(db) < SchemaMigrations::LatestVersion()) {
+      auto migrationDb = db;
+      if (migrationUsername.isString()) {
+        migrationDb = QSqlDatabase::cloneDatabase(db, "openings_migrations");
+        migrationDb.setUserName(migrationUsername.toString());
+        migrationDb.setPassword(migrationPassword.toString());
+      }
+
+      try {
+        if (!migrationDb.isOpen() && !migrationDb.open()) {
+          throw std::runtime_error(migrationDb.lastError().text().toStdString());
+        }
+        SchemaMigrations::Migrate(migrationDb);
+      }
+      catch (std::exception& ex) {
+        QMessageBox::critical( nullptr,
+                               "Error while migrating the database schema.",
+                               ex.what() );
+        return -1;
+      }
+
+      if (migrationDb.connectionName() != db.connectionName()) {
+        migrationDb.close();
+        migrationDb = QSqlDatabase();
+        QSqlDatabase::removeDatabase("openings_migrations");
+      }
+    }
+
+    try {
+      StatementRegistry::Warmup(db);
+    }
+    catch (std::exception& ex) {
+      QMessageBox::critical( nullptr,
+                             "Error while preparing database statements.",
+                             ex.what() );
+      return -1;
+    }
+
+    DatabasePool::Initialize(poolSize.isString() ? poolSize.toString().toInt() : 4);
+
+    try {
+      ResumeCache::Initialize(qint64(resumeCacheMB.isString() ? resumeCacheMB.toString().toInt() : 64) * 1024 * 1024);
+    }
+    catch (std::exception& ex) {
+      QMessageBox::critical( nullptr,
+                             "Error while opening resume cache.",
+                             ex.what() );
+      return -1;
+    }
+
+    QObject::connect(&a, &QCoreApplication::aboutToQuit, [] {
+      DatabasePool::Shutdown();
+      StatementRegistry::Forget(QSqlDatabase::defaultConnection);
+    });
   }
 
   try {